@@ -45,6 +45,8 @@
 
 #include "m_menu.h"
 
+#include "m_misc.h"
+
 // For use if I do walls with outsides/insides
 #define REDS (256 - 5 * 16)
 #define REDRANGE 16
@@ -229,6 +231,32 @@ static cheatseq_t cheat_amap = {cheat_amap_seq, 0};
 
 static byte stopped = true;
 
+//
+// Automap line cache.
+// Linedefs are bucketed by the blockmap cell holding their midpoint.
+// Each bucket keeps its mapped lines first, so the common case only
+// walks lines the player has already seen.
+//
+typedef struct
+{
+	mline_t l;
+	line_t *line;
+} amline_t;
+
+typedef struct
+{
+	fixed_t bbox[4]; // union of the bounding boxes of its lines
+	int first;		 // first entry in amlines
+	int count;
+	int mapped;		 // entries [first, first + mapped) are ML_MAPPED
+} ambucket_t;
+
+static amline_t *amlines;
+static ambucket_t *ambuckets;
+static int *amlinebucket; // bucket of each linedef
+static int *amlineslot;	  // entry of each linedef in amlines
+static int amreach;		  // max cells a line reaches out of its bucket
+
 extern byte viewactive;
 
 #ifdef SUPPORTS_HERCULES_AUTOMAP
@@ -1060,61 +1088,241 @@ void AM_drawGrid(int color)
 	}
 }
 
+//
+// Builds the line cache buckets.
+// Called at level setup, after the blockmap and linedefs are loaded.
+//
+void AM_InitLineCache(void)
+{
+	int i;
+	int numbuckets;
+	int bx, by;
+	int cx, cy;
+	int reach;
+	line_t *li;
+	ambucket_t *bucket;
+
+	numbuckets = bmapwidth * bmapheight;
+	ambuckets = Z_MallocUnowned(numbuckets * sizeof(ambucket_t), PU_LEVEL);
+	amlines = Z_MallocUnowned(numlines * sizeof(amline_t), PU_LEVEL);
+	amlinebucket = Z_MallocUnowned(numlines * sizeof(int), PU_LEVEL);
+	amlineslot = Z_MallocUnowned(numlines * sizeof(int), PU_LEVEL);
+
+	for (i = 0, bucket = ambuckets; i < numbuckets; i++, bucket++)
+	{
+		bucket->bbox[BOXTOP] = bucket->bbox[BOXRIGHT] = MININT;
+		bucket->bbox[BOXBOTTOM] = bucket->bbox[BOXLEFT] = MAXINT;
+		bucket->count = 0;
+	}
+
+	amreach = 0;
+
+	for (i = 0, li = lines; i < numlines; i++, li++)
+	{
+		bx = ((li->bbox[BOXLEFT] >> 1) + (li->bbox[BOXRIGHT] >> 1) - bmaporgx) >> MAPBLOCKSHIFT;
+		by = ((li->bbox[BOXBOTTOM] >> 1) + (li->bbox[BOXTOP] >> 1) - bmaporgy) >> MAPBLOCKSHIFT;
+
+		cx = bx < 0 ? 0 : bx > bmapwidth - 1 ? bmapwidth - 1 : bx;
+		cy = by < 0 ? 0 : by > bmapheight - 1 ? bmapheight - 1 : by;
+
+		// lines outside the blockmap reach further from their clamped cell
+		reach = ((li->bbox[BOXRIGHT] - li->bbox[BOXLEFT]) >> (MAPBLOCKSHIFT + 1)) + 1 + abs(bx - cx);
+		if (reach > amreach)
+			amreach = reach;
+
+		reach = ((li->bbox[BOXTOP] - li->bbox[BOXBOTTOM]) >> (MAPBLOCKSHIFT + 1)) + 1 + abs(by - cy);
+		if (reach > amreach)
+			amreach = reach;
+
+		amlinebucket[i] = bmapwidthmuls[cy] + cx;
+		bucket = &ambuckets[amlinebucket[i]];
+		bucket->count++;
+		M_AddToBox(bucket->bbox, li->bbox[BOXLEFT], li->bbox[BOXBOTTOM]);
+		M_AddToBox(bucket->bbox, li->bbox[BOXRIGHT], li->bbox[BOXTOP]);
+	}
+
+	AM_SortLineCache();
+}
+
+//
+// Scatters the linedefs into their buckets, mapped lines first.
+// Called after anything rewrites ML_MAPPED on all lines (savegames).
+//
+void AM_SortLineCache(void)
+{
+	int i;
+	int numbuckets;
+	int total;
+	int pass;
+	int slot;
+	line_t *li;
+	ambucket_t *bucket;
+	amline_t *aml;
+
+	numbuckets = bmapwidth * bmapheight;
+
+	for (i = 0, bucket = ambuckets; i < numbuckets; i++, bucket++)
+		bucket->mapped = 0;
+
+	for (i = 0, li = lines; i < numlines; i++, li++)
+	{
+		if (li->flags & ML_MAPPED)
+			ambuckets[amlinebucket[i]].mapped++;
+	}
+
+	// prefix sum, count is reused as fill cursor
+	total = 0;
+	for (i = 0, bucket = ambuckets; i < numbuckets; i++, bucket++)
+	{
+		bucket->first = total;
+		total += bucket->count;
+		bucket->count = 0;
+	}
+
+	// mapped lines on the first pass, the rest on the second
+	for (pass = ML_MAPPED; pass >= 0; pass -= ML_MAPPED)
+	{
+		for (i = 0, li = lines; i < numlines; i++, li++)
+		{
+			if ((li->flags & ML_MAPPED) != pass)
+				continue;
+
+			bucket = &ambuckets[amlinebucket[i]];
+			slot = bucket->first + bucket->count++;
+			amlineslot[i] = slot;
+
+			aml = &amlines[slot];
+			aml->l.a.x = li->v1->x;
+			aml->l.a.y = li->v1->y;
+			aml->l.b.x = li->v2->x;
+			aml->l.b.y = li->v2->y;
+			aml->line = li;
+		}
+	}
+}
+
+//
+// Marks a line as seen, moving it into the mapped part of its bucket.
+//
+void AM_MapLine(line_t *line)
+{
+	int i;
+	int slot;
+	int swap;
+	ambucket_t *bucket;
+	amline_t tmp;
+
+	line->flags |= ML_MAPPED;
+
+	i = line - lines;
+	bucket = &ambuckets[amlinebucket[i]];
+	slot = amlineslot[i];
+	swap = bucket->first + bucket->mapped;
+
+	if (slot != swap)
+	{
+		tmp = amlines[swap];
+		amlines[swap] = amlines[slot];
+		amlines[slot] = tmp;
+
+		amlineslot[i] = swap;
+		amlineslot[tmp.line - lines] = slot;
+	}
+
+	bucket->mapped++;
+}
+
 //
 // Determines visible lines, draws them.
 // This is LineDef based, not LineSeg based.
+// Only buckets overlapping the automap window are visited.
 //
 void AM_drawWalls(void)
 {
 	int i;
-	static mline_t l;
-
-	for (i = 0; i < numlines; i++)
+	int end;
+	int x, y;
+	int bx1, bx2;
+	int by1, by2;
+	byte showall;
+	ambucket_t *bucket;
+	amline_t *aml;
+	line_t *li;
+
+	bx1 = ((m_x - bmaporgx) >> MAPBLOCKSHIFT) - amreach;
+	bx2 = ((m_x2 - bmaporgx) >> MAPBLOCKSHIFT) + amreach;
+	by1 = ((m_y - bmaporgy) >> MAPBLOCKSHIFT) - amreach;
+	by2 = ((m_y2 - bmaporgy) >> MAPBLOCKSHIFT) + amreach;
+
+	if (bx1 < 0)
+		bx1 = 0;
+	if (bx2 > bmapwidth - 1)
+		bx2 = bmapwidth - 1;
+	if (by1 < 0)
+		by1 = 0;
+	if (by2 > bmapheight - 1)
+		by2 = bmapheight - 1;
+
+	showall = cheating || players.powers[pw_allmap];
+
+	for (y = by1; y <= by2; y++)
 	{
-		l.a.x = lines[i].v1->x;
-		l.a.y = lines[i].v1->y;
-		l.b.x = lines[i].v2->x;
-		l.b.y = lines[i].v2->y;
-		if (cheating || (lines[i].flags & ML_MAPPED))
+		bucket = &ambuckets[bmapwidthmuls[y] + bx1];
+
+		for (x = bx1; x <= bx2; x++, bucket++)
 		{
-			if ((lines[i].flags & LINE_NEVERSEE) && !cheating)
+			if (bucket->bbox[BOXRIGHT] < m_x || bucket->bbox[BOXLEFT] > m_x2 ||
+				bucket->bbox[BOXTOP] < m_y || bucket->bbox[BOXBOTTOM] > m_y2)
 				continue;
-			if (!lines[i].backsector)
-			{
-				AM_drawMline(&l, WALLCOLORS);
-			}
-			else
+
+			end = showall ? bucket->count : bucket->mapped;
+			aml = &amlines[bucket->first];
+
+			for (i = 0; i < end; i++, aml++)
 			{
-				if (lines[i].special == 39)
-				{ // teleporters
-					AM_drawMline(&l, WALLCOLORS + WALLRANGE / 2);
-				}
-				else if (lines[i].flags & ML_SECRET) // secret door
+				li = aml->line;
+
+				if (cheating || i < bucket->mapped)
 				{
-					if (cheating)
-						AM_drawMline(&l, SECRETWALLCOLORS);
+					if ((li->flags & LINE_NEVERSEE) && !cheating)
+						continue;
+					if (!li->backsector)
+					{
+						AM_drawMline(&aml->l, WALLCOLORS);
+					}
 					else
-						AM_drawMline(&l, WALLCOLORS);
-				}
-				else if (lines[i].backsector->floorheight != lines[i].frontsector->floorheight)
-				{
-					AM_drawMline(&l, FDWALLCOLORS); // floor level change
+					{
+						if (li->special == 39)
+						{ // teleporters
+							AM_drawMline(&aml->l, WALLCOLORS + WALLRANGE / 2);
+						}
+						else if (li->flags & ML_SECRET) // secret door
+						{
+							if (cheating)
+								AM_drawMline(&aml->l, SECRETWALLCOLORS);
+							else
+								AM_drawMline(&aml->l, WALLCOLORS);
+						}
+						else if (li->backsector->floorheight != li->frontsector->floorheight)
+						{
+							AM_drawMline(&aml->l, FDWALLCOLORS); // floor level change
+						}
+						else if (li->backsector->ceilingheight != li->frontsector->ceilingheight)
+						{
+							AM_drawMline(&aml->l, CDWALLCOLORS); // ceiling level change
+						}
+						else if (cheating)
+						{
+							AM_drawMline(&aml->l, TSWALLCOLORS);
+						}
+					}
 				}
-				else if (lines[i].backsector->ceilingheight != lines[i].frontsector->ceilingheight)
+				else if (!(li->flags & LINE_NEVERSEE))
 				{
-					AM_drawMline(&l, CDWALLCOLORS); // ceiling level change
-				}
-				else if (cheating)
-				{
-					AM_drawMline(&l, TSWALLCOLORS);
+					AM_drawMline(&aml->l, GRAYS + 3);
 				}
 			}
 		}
-		else if (players.powers[pw_allmap])
-		{
-			if (!(lines[i].flags & LINE_NEVERSEE))
-				AM_drawMline(&l, GRAYS + 3);
-		}
 	}
 }
 
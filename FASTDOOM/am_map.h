@@ -19,6 +19,8 @@
 #ifndef __AMMAP_H__
 #define __AMMAP_H__
 
+#include "r_defs.h"
+
 // Used by ST StatusBar stuff.
 #define AM_MSGHEADER (('a' << 24) + ('m' << 16))
 #define AM_MSGENTERED (AM_MSGHEADER | ('e' << 8))
@@ -40,4 +42,13 @@ void AM_Drawer(void);
 // if the level is completed while it is up.
 void AM_Stop(void);
 
+// Called by level setup to build the line cache.
+void AM_InitLineCache(void);
+
+// Called after loading a savegame to resync mapped lines.
+void AM_SortLineCache(void);
+
+// Called by the renderer the first time a line is seen.
+void AM_MapLine(line_t *line);
+
 #endif
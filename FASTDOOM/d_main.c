@@ -89,10 +89,13 @@ boolean flatSky;
 boolean flatShadows;
 boolean saturnShadows;
 boolean showFPS;
+boolean showFrameTime;
 boolean unlimitedRAM;
 boolean nearSprites;
 boolean monoSound;
 boolean lowSound;
+boolean accumMix;
+boolean taskStats;
 boolean noMelt;
 
 boolean reverseStereo;
@@ -127,6 +130,9 @@ boolean videoPageFix;
 #endif
 
 boolean logTimedemo;
+boolean demoCheck;
+boolean loadProfile;
+boolean sightStats;
 boolean disableDemo;
 
 boolean uncappedFPS;
@@ -237,6 +243,10 @@ void D_Display(void)
         borderdrawcount = 3;
     }
 
+#ifdef MODE_Y
+    I_WaitFreePage();
+#endif
+
     // save the current screen if about to wipe
     if (gamestate != wipegamestate && !noMelt)
     {
@@ -496,6 +506,9 @@ void D_DoomLoop(void)
 
         // Update display, next frame, with current state.
         D_Display();
+
+        if (timingdemo)
+            G_TimeDemoFrame();
     }
 }
 
@@ -1154,6 +1167,10 @@ void D_DoomMain(void)
 
     lowSound = M_CheckParm("-lowsound");
 
+    accumMix = M_CheckParm("-accummix");
+
+    taskStats = M_CheckParm("-taskstats");
+
     unlimitedRAM = M_CheckParm("-ram");
 
     singletics = M_CheckParm("-singletics");
@@ -1162,6 +1179,12 @@ void D_DoomMain(void)
 
     logTimedemo = M_CheckParm("-logTimedemo");
 
+    demoCheck = M_CheckParm("-democheck");
+
+    loadProfile = M_CheckParm("-loadprofile");
+
+    sightStats = M_CheckParm("-sightstats");
+
     disableDemo = M_CheckParm("-disabledemo");
 
     bfgedition = M_CheckParm("-bfg");
@@ -1286,6 +1309,16 @@ void D_DoomMain(void)
         printf("Playing demo %s.lmp.\n", myargv[p + 1]);
     }
 
+    p = M_CheckParm("-benchsuite");
+    if (p)
+    {
+        while (++p != myargc && myargv[p][0] != '-')
+        {
+            sprintf(file, "%s.lmp", myargv[p]);
+            D_AddFile(file);
+        }
+    }
+
     // get skill / episode / map from parms
     startskill = sk_medium;
     startepisode = 1;
@@ -1324,6 +1357,7 @@ void D_DoomMain(void)
     M_LoadDefaults(); // load before initing other systems
 
     M_CheckParmOptional("-fps", &showFPS);
+    M_CheckParmOptional("-frametime", &showFrameTime);
 
     if (M_CheckParmOptional("-flattersurfaces", &flatSurfaces) && untexturedSurfaces)
     {
@@ -1369,6 +1403,8 @@ void D_DoomMain(void)
     noMelt = 1;
 #endif
 
+    I_DetectCPU();
+
     printf("Z_Init: Init zone memory allocation daemon. \n");
     Z_Init();
 
@@ -1411,6 +1447,11 @@ void D_DoomMain(void)
     ST_Init();
 #endif
 
+#if defined(USE_BACKBUFFER)
+    if (M_CheckParm("-drawbench"))
+        R_DrawBench(); // never returns
+#endif
+
     // start the apropriate game based on parms
     p = M_CheckParm("-record");
 
@@ -1435,6 +1476,13 @@ void D_DoomMain(void)
         D_DoomLoop(); // never returns
     }
 
+    p = M_CheckParm("-benchsuite");
+    if (p && p < myargc - 1)
+    {
+        G_BenchSuite(p + 1);
+        D_DoomLoop(); // never returns
+    }
+
     p = M_CheckParm("-loadgame");
     if (p && p < myargc - 1)
     {
@@ -143,6 +143,11 @@ typedef struct player_s
     // True if secret level has been done.
     boolean didsecret;
 
+    // Savegames end here, the fields below are set up again on load.
+
+    // viewz at the start of the last tic, for interpolation.
+    fixed_t oldviewz;
+
 } player_t;
 
 //
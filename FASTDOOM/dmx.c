@@ -19,6 +19,7 @@
 
 #include "dmx.h"
 #include "doomdef.h"
+#include "z_zone.h"
 #include "ns_fxm.h"
 #include "ns_music.h"
 #include "ns_task.h"
@@ -185,6 +186,69 @@ int SFX_PlayPatch(void *vdata, int sep, int vol)
 
     return -1;
 }
+
+//
+// SFX_Resample
+// Converts a digital sound lump to the mixer rate once, so the
+// mixer reads it one sample per output sample. The copy keeps
+// the lump layout and is purgeable.
+//
+void SFX_Resample(void *vdata, void **user)
+{
+    unsigned char *data = (unsigned char *)vdata;
+    unsigned char *out;
+    unsigned int type = data[0] | (data[1] << 8);
+    unsigned int rate;
+    unsigned int mixrate;
+    unsigned long len;
+    unsigned long outlen;
+    unsigned long frac;
+    unsigned long step;
+    unsigned long i;
+
+    if (type != 3)
+        return;
+
+    rate = (data[3] << 8) | data[2];
+    len = (data[7] << 24) | (data[6] << 16) | (data[5] << 8) | data[4];
+    mixrate = MV_GetMixRate();
+
+    if (len <= 48 || mixrate == 0 || rate == mixrate || (rate != 11025 && rate != 22050))
+        return;
+
+    len -= 32;
+    outlen = (len / rate) * mixrate + ((len % rate) * mixrate) / rate;
+
+    if (outlen + 32 <= 48)
+        return;
+
+    out = Z_Malloc(outlen + 56, PU_CACHE, user);
+
+    out[0] = 3;
+    out[1] = 0;
+    out[2] = mixrate & 0xff;
+    out[3] = mixrate >> 8;
+    out[4] = (outlen + 32) & 0xff;
+    out[5] = ((outlen + 32) >> 8) & 0xff;
+    out[6] = ((outlen + 32) >> 16) & 0xff;
+    out[7] = (outlen + 32) >> 24;
+
+    // Same padding as the lump
+    memset(out + 8, 0x80, 16);
+    memset(out + 24 + outlen, 0x80, 16);
+
+    // Pick the same samples the mixer would have stepped over
+    data += 24;
+    step = (rate << 16) / mixrate;
+    for (i = 0, frac = 0; i < outlen; i++)
+    {
+        out[24 + i] = *data;
+        frac += step;
+        data += frac >> 16;
+        frac &= 0xffff;
+    }
+}
+
 void SFX_StopPatch(int handle)
 {
     if (handle & 0x8000)
@@ -357,6 +421,8 @@ int ASS_GetSoundCardCode(int sndDevice)
         return OPL2LPT;
     case snd_OPL3LPT:
         return OPL3LPT;
+    case snd_DISK:
+        return DiskWriter;
     default:
         return -1;
     }
@@ -410,6 +476,8 @@ void ASS_Init(int rate, int maxsng, int mdev, int sdev)
 
     sample_rate = lowSound ? 8000 : 11025;
 
+    MV_Accumulate = accumMix;
+
     status = FX_Init(sound_device, numChannels, 2, 8, sample_rate);
 
     FX_SetVolume(255);
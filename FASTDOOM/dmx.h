@@ -25,6 +25,7 @@ int MUS_RegisterSong(void *data);
 int MUS_ChainSong(int handle, int next);
 void MUS_PlaySong(int handle, int volume);
 int SFX_PlayPatch(void *vdata, int sep, int vol);
+void SFX_Resample(void *vdata, void **user);
 void SFX_StopPatch(int handle);
 int SFX_Playing(int handle);
 void SFX_SetOrigin(int handle, int sep, int vol);
@@ -49,10 +49,13 @@ extern boolean flatSky;
 extern boolean flatShadows;
 extern boolean saturnShadows;
 extern boolean showFPS;
+extern boolean showFrameTime;
 extern boolean unlimitedRAM;
 extern boolean nearSprites;
 extern boolean monoSound;
 extern boolean lowSound;
+extern boolean accumMix;
+extern boolean taskStats;
 extern boolean noMelt;
 
 extern boolean reverseStereo;
@@ -87,6 +90,9 @@ extern boolean videoPageFix;
 #endif
 
 extern boolean logTimedemo;
+extern boolean demoCheck;
+extern boolean loadProfile;
+extern boolean sightStats;
 extern boolean disableDemo;
 
 extern boolean uncappedFPS;
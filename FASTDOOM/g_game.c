@@ -65,6 +65,8 @@
 
 #include "options.h"
 
+#include "ns_task.h"
+
 #define SAVEGAMESIZE 0x2c000
 #define SAVESTRINGSIZE 24
 
@@ -98,6 +100,12 @@ byte usergame;  // ok to save / end game
 byte timingdemo = 0; // if true, exit with report on completion
 int starttime;       // for comparative timing purposes
 
+byte benchsuite = 0;  // if true, timed demos are chained by G_BenchRunDone
+int benchstarttime;   // first level load of the current benchmark run
+int benchstartgametic;
+unsigned long lastframeclock;   // PIT clock when the last frame was finished
+unsigned long worstframeclocks; // longest frame since the level was loaded
+
 byte viewactive;
 
 boolean playeringame;
@@ -349,6 +357,14 @@ void G_DoLoadLevel(void)
 
     P_SetupLevel(gameepisode, gamemap, 0, gameskill);
     starttime = ticcount;
+    lastframeclock = TS_GetClock();
+
+    if (benchsuite && benchstarttime < 0)
+    {
+        benchstarttime = ticcount;
+        benchstartgametic = gametic;
+        worstframeclocks = 0;
+    }
     gameaction = ga_nothing;
 
     // clear cmd building stuff
@@ -659,6 +675,9 @@ void G_DoCompleted(void)
 
     gameaction = ga_nothing;
 
+    I_LogFrameTimes();
+    P_LogSightStats();
+
     G_PlayerFinishLevel(); // take away cards and stuff
 
 #if defined(MODE_Y) || defined(USE_BACKBUFFER) || defined(MODE_VBE2_DIRECT)
@@ -849,6 +868,7 @@ void G_DoLoadGame(void)
     // dearchive all the modifications
     P_UnArchivePlayers();
     P_UnArchiveWorld();
+    AM_SortLineCache();
     P_UnArchiveThinkers();
     P_UnArchiveSpecials();
 
@@ -1168,6 +1188,84 @@ void G_BeginRecording(void)
 
 char *defdemoname;
 
+//
+// Demo checksums
+// Every played tic is hashed and compared against <demo>.chk,
+// or written to it if the file does not exist yet.
+//
+static FILE *democheckfile;
+static byte democheckwrite;
+static int demochecktics;
+
+static const char *democheckname[NUMDEMOCHECKS] = {
+    "player", "random", "mobjs", "sectors"};
+
+void G_BeginDemoCheck(void)
+{
+    char name[16];
+
+    // a demo loop interrupted by a new game leaves the last one open
+    if (democheckfile)
+        fclose(democheckfile);
+
+    sprintf(name, "%.8s.chk", defdemoname);
+    demochecktics = 0;
+
+    democheckfile = fopen(name, "rb");
+    democheckwrite = democheckfile == NULL;
+
+    if (democheckwrite)
+        democheckfile = fopen(name, "wb");
+
+    if (!democheckfile)
+        I_Error("Couldn't open demo checksum file %s", name);
+}
+
+void G_DemoCheckTic(void)
+{
+    int i;
+    unsigned int sums[NUMDEMOCHECKS + 1];
+    unsigned int stored[NUMDEMOCHECKS + 1];
+
+    sums[0] = demochecktics++;
+    P_ChecksumTic(sums + 1);
+
+    if (democheckwrite)
+    {
+        fwrite(sums, sizeof(sums), 1, democheckfile);
+        return;
+    }
+
+    if (fread(stored, sizeof(stored), 1, democheckfile) != 1)
+        I_Error("Demo %s desync at tic %i: checksum file ends early", defdemoname, sums[0]);
+
+    for (i = 1; i <= NUMDEMOCHECKS; i++)
+    {
+        if (stored[i] != sums[i])
+            I_Error("Demo %s desync at tic %i: %s state differs", defdemoname, sums[0], democheckname[i - 1]);
+    }
+}
+
+void G_EndDemoCheck(void)
+{
+    unsigned int stored;
+    byte leftover;
+
+    if (!democheckfile)
+        return;
+
+    leftover = !democheckwrite && fread(&stored, sizeof(stored), 1, democheckfile) == 1;
+    fclose(democheckfile);
+    democheckfile = NULL;
+
+    if (leftover)
+        I_Error("Demo %s desync at tic %i: demo ends early", defdemoname, demochecktics);
+
+    // timedemo reports its own result
+    if (singledemo && !timingdemo)
+        I_Error("Demo %s %s, %i tics", defdemoname, democheckwrite ? "checksums written" : "verified", demochecktics);
+}
+
 void G_DeferedPlayDemo(char *name)
 {
     if (!disableDemo)
@@ -1203,11 +1301,17 @@ void G_DoPlayDemo(void)
     *demo_p++;
     *demo_p++;
 
+    // the run's timing starts at its first level load, inside G_InitNew
+    benchstarttime = -1;
+
     // don't spend a lot of time in loadlevel
     G_InitNew(skill, episode, map);
 
     usergame = 0;
     demoplayback = 1;
+
+    if (demoCheck)
+        G_BeginDemoCheck();
 }
 
 //
@@ -1222,6 +1326,267 @@ void G_TimeDemo(char *name)
     gameaction = ga_playdemo;
 }
 
+//
+// G_TimeDemoFrame
+// Called after every displayed frame while timing a demo.
+//
+void G_TimeDemoFrame(void)
+{
+    unsigned long clock;
+
+    clock = TS_GetClock();
+
+    if (clock - lastframeclock > worstframeclocks)
+        worstframeclocks = clock - lastframeclock;
+
+    lastframeclock = clock;
+}
+
+//
+// Benchmark suite
+// Every demo is timed with every combination of the selected
+// renderer options, several times each, without restarting.
+//
+extern int detailLevel;
+extern int screenblocks;
+
+#define MAXBENCHDEMOS 16
+#define MAXBENCHRUNS 32
+
+typedef struct
+{
+    char *name;
+    int numvalues;
+    void (*apply)(int value);
+} benchaxis_t;
+
+static void G_BenchDetail(int value)
+{
+    detailLevel = value;
+}
+
+static void G_BenchVisplanes(int value)
+{
+    untexturedSurfaces = value == 1;
+    flatSurfaces = value == 2;
+}
+
+static void G_BenchSky(int value)
+{
+    flatSky = value;
+}
+
+static void G_BenchShadows(int value)
+{
+    flatShadows = value == 1;
+    saturnShadows = value == 2;
+}
+
+static void G_BenchSprites(int value)
+{
+    nearSprites = value;
+}
+
+static benchaxis_t benchaxes[] = {
+    {"detail", 3, G_BenchDetail},
+    {"visplanes", 3, G_BenchVisplanes},
+    {"sky", 2, G_BenchSky},
+    {"shadows", 3, G_BenchShadows},
+    {"sprites", 2, G_BenchSprites}};
+
+#define NUMBENCHAXES (sizeof(benchaxes) / sizeof(benchaxis_t))
+
+static char *benchdemos[MAXBENCHDEMOS];
+static int numbenchdemos;
+static benchaxis_t *benchmatrix[NUMBENCHAXES];
+static int numbenchmatrix;
+static int numbenchcombos;
+static int benchruns;
+static int benchrun; // index over demos x combos x runs
+
+static int benchfps[MAXBENCHRUNS];
+static int benchrealtics[MAXBENCHRUNS];
+static unsigned long benchworstframe[MAXBENCHRUNS];
+
+//
+// G_BenchOptions
+// Applies combination <combo> and formats it into <str>.
+//
+static void G_BenchOptions(int combo, char *str)
+{
+    int i;
+    int value;
+
+    *str = '\0';
+
+    for (i = 0; i < numbenchmatrix; i++)
+    {
+        value = combo % benchmatrix[i]->numvalues;
+        combo /= benchmatrix[i]->numvalues;
+
+        benchmatrix[i]->apply(value);
+        str += sprintf(str, "%s%s=%i", i ? " " : "", benchmatrix[i]->name, value);
+    }
+
+    R_SetViewSize(screenblocks, detailLevel);
+}
+
+static void G_BenchStartRun(void)
+{
+    char options[64];
+    int run;
+
+    run = benchrun % benchruns;
+
+    if (run == 0)
+        G_BenchOptions((benchrun / benchruns) % numbenchcombos, options);
+
+    defdemoname = benchdemos[benchrun / (benchruns * numbenchcombos)];
+    gameaction = ga_playdemo;
+}
+
+//
+// G_BenchSuite
+// Only called by startup code, <p> is the first demo name.
+//
+void G_BenchSuite(int p)
+{
+    int i;
+    int j;
+    FILE *logFile;
+
+    numbenchdemos = 0;
+    while (p < myargc && myargv[p][0] != '-')
+    {
+        if (numbenchdemos == MAXBENCHDEMOS)
+            I_Error("G_BenchSuite: more than %i demos given to -benchsuite", MAXBENCHDEMOS);
+
+        benchdemos[numbenchdemos++] = myargv[p++];
+    }
+
+    if (!numbenchdemos)
+        I_Error("No demos given to -benchsuite");
+
+    benchruns = 1;
+    i = M_CheckParm("-benchruns");
+    if (i && i < myargc - 1)
+        benchruns = atoi(myargv[i + 1]);
+
+    if (benchruns < 1)
+        benchruns = 1;
+    else if (benchruns > MAXBENCHRUNS)
+        benchruns = MAXBENCHRUNS;
+
+    numbenchmatrix = 0;
+    numbenchcombos = 1;
+    p = M_CheckParm("-benchopts");
+    if (p)
+    {
+        while (++p < myargc && myargv[p][0] != '-')
+        {
+            for (j = 0; j < NUMBENCHAXES; j++)
+            {
+                if (!strcasecmp(myargv[p], benchaxes[j].name))
+                {
+                    benchmatrix[numbenchmatrix++] = &benchaxes[j];
+                    numbenchcombos *= benchaxes[j].numvalues;
+                    break;
+                }
+            }
+
+            if (j == NUMBENCHAXES)
+                I_Error("Unknown -benchopts option %s", myargv[p]);
+        }
+    }
+
+    logFile = fopen("bench.txt", "a");
+    if (logFile)
+    {
+        fprintf(logFile, "# type,demo,options,run,gametics,realtics,fps,worstframe_ms\n");
+        fprintf(logFile, "# type,demo,options,runs,min_fps,avg_fps,max_fps\n");
+        fclose(logFile);
+    }
+
+    benchsuite = 1;
+    timingdemo = 1;
+    singledemo = 1;
+    singletics = true;
+    benchrun = 0;
+
+    G_BenchStartRun();
+}
+
+//
+// G_BenchRunDone
+// Called from G_CheckDemoStatus when a benchmark demo ends.
+//
+static void G_BenchRunDone(void)
+{
+    int i;
+    int run;
+    int gametics;
+    int realtics;
+    int minfps, maxfps;
+    int totalfps;
+    char options[64];
+    FILE *logFile;
+
+    run = benchrun % benchruns;
+
+    gametics = gametic - benchstartgametic;
+    realtics = ticcount - benchstarttime;
+    if (realtics < 1)
+        realtics = 1;
+
+    benchfps[run] = FixedMul(FixedDiv(gametics << FRACBITS, realtics << FRACBITS), 35 << FRACBITS);
+    benchrealtics[run] = realtics;
+    benchworstframe[run] = worstframeclocks;
+
+    // the option string is rebuilt without changing anything
+    G_BenchOptions((benchrun / benchruns) % numbenchcombos, options);
+
+    logFile = fopen("bench.txt", "a");
+    if (logFile)
+    {
+        fprintf(logFile, "run,%s,%s,%i,%i,%i,%i.%03i,%lu.%i\n", defdemoname, options, run + 1, gametics, realtics,
+                benchfps[run] >> FRACBITS, Mul1000(benchfps[run] & 65535) >> FRACBITS,
+                benchworstframe[run] / PITCLOCKSPERMS, Mul10(benchworstframe[run] % PITCLOCKSPERMS) / PITCLOCKSPERMS);
+
+        if (run == benchruns - 1)
+        {
+            minfps = maxfps = totalfps = benchfps[0];
+            for (i = 1; i < benchruns; i++)
+            {
+                if (benchfps[i] < minfps)
+                    minfps = benchfps[i];
+                if (benchfps[i] > maxfps)
+                    maxfps = benchfps[i];
+                totalfps += benchfps[i];
+            }
+            totalfps /= benchruns;
+
+            fprintf(logFile, "summary,%s,%s,%i,%i.%03i,%i.%03i,%i.%03i\n", defdemoname, options, benchruns,
+                    minfps >> FRACBITS, Mul1000(minfps & 65535) >> FRACBITS,
+                    totalfps >> FRACBITS, Mul1000(totalfps & 65535) >> FRACBITS,
+                    maxfps >> FRACBITS, Mul1000(maxfps & 65535) >> FRACBITS);
+        }
+
+        fclose(logFile);
+    }
+
+    Z_ChangeTag(demobuffer, PU_CACHE);
+    demoplayback = 0;
+    respawnparm = false;
+    fastparm = false;
+    nomonsters = false;
+
+    benchrun++;
+    if (benchrun == numbenchdemos * numbenchcombos * benchruns)
+        I_Error("Benchmark suite finished, %i runs saved in bench.txt", benchrun);
+
+    G_BenchStartRun();
+}
+
 /* 
 =================== 
 = 
@@ -1238,6 +1603,16 @@ void G_CheckDemoStatus(void)
     int realtics;
     int resultfps;
 
+    G_EndDemoCheck();
+    I_LogFrameTimes();
+    P_LogSightStats();
+
+    if (benchsuite)
+    {
+        G_BenchRunDone();
+        return;
+    }
+
     if (timingdemo)
     {
         endtime = ticcount;
@@ -50,8 +50,13 @@ void G_BeginRecording(void);
 
 void G_PlayDemo(char *name);
 void G_TimeDemo(char *name);
+void G_TimeDemoFrame(void);
+void G_BenchSuite(int p);
 void G_CheckDemoStatus(void);
 
+// Called by P_Ticker when -democheck is given.
+void G_DemoCheckTic(void);
+
 void G_ExitLevel(void);
 void G_SecretExitLevel(void);
 
@@ -38,6 +38,8 @@
 
 #include "options.h"
 
+#include "ns_task.h"
+
 //
 // Locally used constants, shortcuts.
 //
@@ -58,6 +60,7 @@
 patch_t *hu_font[HU_FONTSIZE];
 static hu_textline_t w_title;
 static hu_textline_t w_fps;
+static hu_textline_t w_frametime;
 
 static byte message_on;
 byte message_dontfuckwithme;
@@ -278,6 +281,11 @@ void HU_Start(void)
                        hu_font,
                        HU_FONTSTART);
 
+    HUlib_initTextLine(&w_frametime,
+                       HU_INPUTX, HU_INPUTY,
+                       hu_font,
+                       HU_FONTSTART);
+
     // create the map title widget
     HUlib_initTextLine(&w_title,
                        HU_TITLEX, HU_TITLEY,
@@ -355,6 +363,26 @@ void HU_Drawer(void)
         }
     }
 
+    if (showFrameTime)
+    {
+        // frame times in tenths of ms from PIT clocks
+        sprintf(str, "MED %i.%i 1%% %i.%i MAX %i.%i IO %i",
+                frametimemedian / PITCLOCKSPERMS, Mul10(frametimemedian % PITCLOCKSPERMS) / PITCLOCKSPERMS,
+                frametimelow / PITCLOCKSPERMS, Mul10(frametimelow % PITCLOCKSPERMS) / PITCLOCKSPERMS,
+                frametimemax / PITCLOCKSPERMS, Mul10(frametimemax % PITCLOCKSPERMS) / PITCLOCKSPERMS,
+                frametimeio);
+        HUlib_clearTextLine(&w_frametime);
+        f = str;
+        while (*f)
+        {
+            HUlib_addCharToTextLine(&w_frametime, *(f++));
+        }
+        HUlib_drawTextLine(&w_frametime);
+#if defined(USE_BACKBUFFER)
+        updatestate |= I_MESSAGES;
+#endif
+    }
+
 #if defined(MODE_Y) || defined(USE_BACKBUFFER) || defined(MODE_VBE2_DIRECT)
     if (automapactive)
         HUlib_drawTextLine(&w_title);
@@ -367,6 +395,7 @@ void HU_Erase(void)
     HUlib_eraseSText(&w_message);
     HUlib_eraseTextLine(&w_title);
     HUlib_eraseTextLine(&w_fps);
+    HUlib_eraseTextLine(&w_frametime);
 }
 
 void HU_Ticker(void)
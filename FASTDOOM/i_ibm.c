@@ -1361,6 +1361,11 @@ void I_ProcessPalette(byte *palette)
 //
 void I_SetPalette(int numpalette)
 {
+#if defined(USE_DIRTYROWS)
+    // The palette is baked into video memory, convert everything again
+    updatestate |= I_FULLSCRN;
+#endif
+
 #if defined(MODE_HERC)
     ptrlutcolors = lutcolors + numpalette * 1024;
 #endif
@@ -1426,6 +1431,140 @@ void I_SetPalette(int numpalette)
 
 #if defined(USE_BACKBUFFER)
 int updatestate;
+
+// Status bar rectangles changed since the last update
+damagerect_t damagerects[MAXDAMAGE];
+int numdamagerects;
+
+//
+// I_AddDamage
+// Adds a rectangle to a damage list. Rectangles already covered
+// are dropped, and a full list collapses to its bounding box.
+//
+void I_AddDamage(damagerect_t *rects, int *count, int x, int y, int w, int h)
+{
+    int i;
+    int x2, y2;
+
+    if (x < 0)
+    {
+        w += x;
+        x = 0;
+    }
+    if (y < 0)
+    {
+        h += y;
+        y = 0;
+    }
+    if (x + w > SCREENWIDTH)
+        w = SCREENWIDTH - x;
+    if (y + h > SCREENHEIGHT)
+        h = SCREENHEIGHT - y;
+
+    if (w <= 0 || h <= 0)
+        return;
+
+    for (i = 0; i < *count; i++)
+    {
+        if (x >= rects[i].x && y >= rects[i].y && x + w <= rects[i].x + rects[i].w && y + h <= rects[i].y + rects[i].h)
+            return;
+    }
+
+    if (*count == MAXDAMAGE)
+    {
+        x2 = x + w;
+        y2 = y + h;
+
+        for (i = 0; i < MAXDAMAGE; i++)
+        {
+            if (rects[i].x < x)
+                x = rects[i].x;
+            if (rects[i].y < y)
+                y = rects[i].y;
+            if (rects[i].x + rects[i].w > x2)
+                x2 = rects[i].x + rects[i].w;
+            if (rects[i].y + rects[i].h > y2)
+                y2 = rects[i].y + rects[i].h;
+        }
+
+        w = x2 - x;
+        h = y2 - y;
+        *count = 0;
+    }
+
+    rects[*count].x = x;
+    rects[*count].y = y;
+    rects[*count].w = w;
+    rects[*count].h = h;
+    (*count)++;
+}
+
+void I_DirtyStatBar(int x, int y, int w, int h)
+{
+    updatestate |= I_STATBAR;
+    I_AddDamage(damagerects, &numdamagerects, x, y, w, h);
+}
+#endif
+
+#if defined(USE_DIRTYROWS)
+//
+// I_DirtyRows
+// Backbuffer rows the converting blitters have to process, in
+// pairs since every pass of theirs covers two rows
+//
+int dirtytop;
+int dirtybottom;
+
+void I_DirtyRows(void)
+{
+    int i;
+
+    // Menus draw without reporting what they cover
+    if ((updatestate & I_FULLSCRN) || menuactive)
+    {
+        dirtytop = 0;
+        dirtybottom = SCREENHEIGHT;
+        return;
+    }
+
+    dirtytop = SCREENHEIGHT;
+    dirtybottom = 0;
+
+    if (updatestate & I_MESSAGES)
+    {
+        dirtytop = 0;
+        dirtybottom = 28;
+    }
+
+    if (updatestate & I_FULLVIEW)
+    {
+        if (viewwindowy < dirtytop)
+            dirtytop = viewwindowy;
+        if (viewwindowy + viewheight > dirtybottom)
+            dirtybottom = viewwindowy + viewheight;
+    }
+
+    if (updatestate & I_STATBAR)
+    {
+        if (!numdamagerects)
+        {
+            if (SCREENHEIGHT - SBARHEIGHT < dirtytop)
+                dirtytop = SCREENHEIGHT - SBARHEIGHT;
+            dirtybottom = SCREENHEIGHT;
+        }
+
+        for (i = 0; i < numdamagerects; i++)
+        {
+            if (damagerects[i].y < dirtytop)
+                dirtytop = damagerects[i].y;
+            if (damagerects[i].y + damagerects[i].h > dirtybottom)
+                dirtybottom = damagerects[i].y + damagerects[i].h;
+        }
+    }
+
+    dirtytop &= ~1;
+    dirtybottom = (dirtybottom + 1) & ~1;
+}
 #endif
 byte *pcscreen, *destscreen, *destview;
 unsigned short *currentscreen;
@@ -1716,9 +1855,13 @@ extern int screenblocks;
 #ifdef MODE_CGA_BW
 void CGA_BW_DrawBackbuffer(void)
 {
-    unsigned char *vram = (unsigned char *)0xB8000;
-    unsigned short *ptrvrambuffer = vrambuffer;
-    byte *ptrbackbuffer = backbuffer;
+    unsigned char *vram = (unsigned char *)0xB8000 + Mul80(dirtytop >> 1);
+    unsigned char *vramend = (unsigned char *)0xB8000 + Mul80(dirtybottom >> 1);
+    unsigned short *ptrvrambuffer = vrambuffer + Mul80(dirtytop >> 1);
+    byte *ptrbackbuffer = backbuffer + Mul320(dirtytop);
+
+    if (dirtytop >= dirtybottom)
+        return;
 
     do
     {
@@ -1768,16 +1911,20 @@ void CGA_BW_DrawBackbuffer(void)
         } while (x > 0);
 
         ptrbackbuffer += 320;
-    } while (vram < 0xB9F40);
+    } while (vram < vramend);
 }
 #endif
 
 #ifdef MODE_HERC
 void HERC_DrawBackbuffer(void)
 {
-    unsigned char *vram = (unsigned char *)0xB0000;
-    byte *ptrvrambuffer = vrambuffer;
-    byte *ptrbackbuffer = backbuffer;
+    unsigned char *vram = (unsigned char *)0xB0000 + Mul80(dirtytop >> 1);
+    unsigned char *vramend = (unsigned char *)0xB0000 + Mul80(dirtybottom >> 1);
+    byte *ptrvrambuffer = vrambuffer + Mul80(dirtytop >> 1);
+    byte *ptrbackbuffer = backbuffer + Mul320(dirtytop);
+
+    if (dirtytop >= dirtybottom)
+        return;
 
     do
     {
@@ -1848,17 +1995,21 @@ void HERC_DrawBackbuffer(void)
         } while (x > 0);
 
         ptrbackbuffer += 320;
-    } while (vram < 0xB1F40);
+    } while (vram < vramend);
 }
 #endif
 
 #ifdef MODE_CGA16
 void CGA16_DrawBackbuffer_Snow(void)
 {
-    unsigned char *vram = (unsigned char *)0xB8001;
+    unsigned char *vram = (unsigned char *)0xB8001 + Mul160(dirtytop >> 1);
+    unsigned char *vramend = (unsigned char *)0xB8000 + Mul160(dirtybottom >> 1);
     unsigned char line = 80;
-    byte *ptrbackbuffer = backbuffer;
-    byte *ptrvrambuffer = vrambuffer;
+    byte *ptrbackbuffer = backbuffer + Mul320(dirtytop);
+    byte *ptrvrambuffer = vrambuffer + Mul160(dirtytop >> 1);
+
+    if (dirtytop >= dirtybottom)
+        return;
 
     do
     {
@@ -1881,15 +2032,19 @@ void CGA16_DrawBackbuffer_Snow(void)
             line = 80;
             ptrbackbuffer += 320;
         }
-    } while (vram < (unsigned char *)0xBBE80);
+    } while (vram < vramend);
 }
 
 void CGA16_DrawBackbuffer(void)
 {
-    unsigned char *vram = (unsigned char *)0xB8001;
+    unsigned char *vram = (unsigned char *)0xB8001 + Mul160(dirtytop >> 1);
+    unsigned char *vramend = (unsigned char *)0xB8000 + Mul160(dirtybottom >> 1);
     unsigned char line = 80;
-    byte *ptrbackbuffer = backbuffer;
-    byte *ptrvrambuffer = vrambuffer;
+    byte *ptrbackbuffer = backbuffer + Mul320(dirtytop);
+    byte *ptrvrambuffer = vrambuffer + Mul160(dirtytop >> 1);
+
+    if (dirtytop >= dirtybottom)
+        return;
 
     do
     {
@@ -1911,19 +2066,23 @@ void CGA16_DrawBackbuffer(void)
             line = 80;
             ptrbackbuffer += 320;
         }
-    } while (vram < (unsigned char *)0xBBE80);
+    } while (vram < vramend);
 }
 #endif
 
 #ifdef MODE_CGA_AFH
 void CGA_AFH_DrawBackbuffer_Snow(void)
 {
-    unsigned short *vram = (unsigned short *)0xB8000;
+    unsigned short *vram = (unsigned short *)0xB8000 + Mul80(dirtytop >> 1);
+    unsigned short *vramend = (unsigned short *)0xB8000 + Mul80(dirtybottom >> 1);
     unsigned char line = 80;
-    byte *ptrbackbuffer = backbuffer;
-    unsigned short *ptrvrambuffer = vrambuffer;
+    byte *ptrbackbuffer = backbuffer + Mul320(dirtytop);
+    unsigned short *ptrvrambuffer = vrambuffer + Mul80(dirtytop >> 1);
     unsigned short *ptrLUT = ansifromhellLUT;
 
+    if (dirtytop >= dirtybottom)
+        return;
+
     do
     {
         unsigned short lutPOS = (ptrlut16colors[*(ptrbackbuffer)]     & 0x000F) |
@@ -1949,17 +2108,21 @@ void CGA_AFH_DrawBackbuffer_Snow(void)
             line = 80;
             ptrbackbuffer += 320;
         }
-    } while (vram < (unsigned short *)0xBBE80);
+    } while (vram < vramend);
 }
 
 void CGA_AFH_DrawBackbuffer(void)
 {
-    unsigned short *vram = (unsigned short *)0xB8000;
+    unsigned short *vram = (unsigned short *)0xB8000 + Mul80(dirtytop >> 1);
+    unsigned short *vramend = (unsigned short *)0xB8000 + Mul80(dirtybottom >> 1);
     unsigned char line = 80;
-    byte *ptrbackbuffer = backbuffer;
-    unsigned short *ptrvrambuffer = vrambuffer;
+    byte *ptrbackbuffer = backbuffer + Mul320(dirtytop);
+    unsigned short *ptrvrambuffer = vrambuffer + Mul80(dirtytop >> 1);
     unsigned short *ptrLUT = ansifromhellLUT;
 
+    if (dirtytop >= dirtybottom)
+        return;
+
     do
     {
         unsigned short lutPOS = (ptrlut16colors[*(ptrbackbuffer)]     & 0x000F) |
@@ -1983,7 +2146,7 @@ void CGA_AFH_DrawBackbuffer(void)
             line = 80;
             ptrbackbuffer += 320;
         }
-    } while (vram < (unsigned short *)0xBBE80);
+    } while (vram < vramend);
 }
 
 #endif
@@ -1991,10 +2154,14 @@ void CGA_AFH_DrawBackbuffer(void)
 #ifdef MODE_EGA16
 void EGA16_DrawBackbuffer(void)
 {
-    unsigned char *vram = (unsigned char *)0xB8501;
+    unsigned char *vram = (unsigned char *)0xB8501 + Mul160(dirtytop >> 1);
+    unsigned char *vramend = (unsigned char *)0xB8500 + Mul160(dirtybottom >> 1);
     unsigned char line = 80;
-    byte *ptrbackbuffer = backbuffer;
-    byte *ptrvrambuffer = vrambuffer;
+    byte *ptrbackbuffer = backbuffer + Mul320(dirtytop);
+    byte *ptrvrambuffer = vrambuffer + Mul160(dirtytop >> 1);
+
+    if (dirtytop >= dirtybottom)
+        return;
 
     do
     {
@@ -2016,18 +2183,22 @@ void EGA16_DrawBackbuffer(void)
             line = 80;
             ptrbackbuffer += 320;
         }
-    } while (vram < (unsigned char *)0xBC380);
+    } while (vram < vramend);
 }
 #endif
 
 #ifdef MODE_CGA136
 void CGA136_DrawBackbuffer_Snow(void)
 {
-    unsigned char *vram = (unsigned char *)0xB8001;
-    byte *ptrbackbuffer = backbuffer;
-    byte *ptrvrambuffer = vrambuffer;
+    unsigned char *vram = (unsigned char *)0xB8001 + Mul160(dirtytop >> 1);
+    unsigned char *vramend = (unsigned char *)0xB8000 + Mul160(dirtybottom >> 1);
+    byte *ptrbackbuffer = backbuffer + Mul320(dirtytop);
+    byte *ptrvrambuffer = vrambuffer + Mul160(dirtytop >> 1);
     unsigned char line = 20;
 
+    if (dirtytop >= dirtybottom)
+        return;
+
     do
     {
         unsigned char tmp = ptrlut136colors[*ptrbackbuffer];
@@ -2076,16 +2247,20 @@ void CGA136_DrawBackbuffer_Snow(void)
             line = 20;
             ptrbackbuffer += 320;
         }
-    } while (vram < (unsigned char *)0xBBE80);
+    } while (vram < vramend);
 }
 
 void CGA136_DrawBackbuffer(void)
 {
-    unsigned char *vram = (unsigned char *)0xB8001;
-    byte *ptrbackbuffer = backbuffer;
-    byte *ptrvrambuffer = vrambuffer;
+    unsigned char *vram = (unsigned char *)0xB8001 + Mul160(dirtytop >> 1);
+    unsigned char *vramend = (unsigned char *)0xB8000 + Mul160(dirtybottom >> 1);
+    byte *ptrbackbuffer = backbuffer + Mul320(dirtytop);
+    byte *ptrvrambuffer = vrambuffer + Mul160(dirtytop >> 1);
     unsigned char line = 20;
 
+    if (dirtytop >= dirtybottom)
+        return;
+
     do
     {
         unsigned char tmp = ptrlut136colors[*ptrbackbuffer];
@@ -2130,7 +2305,7 @@ void CGA136_DrawBackbuffer(void)
             line = 20;
             ptrbackbuffer += 320;
         }
-    } while (vram < (unsigned char *)0xBBE80);
+    } while (vram < vramend);
 }
 #endif
 
@@ -3063,11 +3238,12 @@ void PCP_DrawBackbuffer(void)
 void CGA_DrawBackbuffer(void)
 {
     int x;
-    unsigned char *vram = (unsigned char *)0xB8000;
-    unsigned short *ptrvrambuffer = vrambuffer;
+    unsigned char *vram = (unsigned char *)0xB8000 + Mul80(dirtytop >> 1);
+    unsigned short *ptrvrambuffer = vrambuffer + Mul80(dirtytop >> 1);
     unsigned int base = 0;
+    unsigned int baseend = Mul320(dirtybottom);
 
-    for (base = 0; base < SCREENHEIGHT * 320; base += 320)
+    for (base = Mul320(dirtytop); base < baseend; base += 320)
     {
         for (x = 0; x < SCREENWIDTH / 4; x++, base += 4, vram++, ptrvrambuffer++)
         {
@@ -3115,12 +3291,277 @@ int vesalinear = -1;
 char *vesavideoptr;
 #endif
 
+#if defined(MODE_VBE2) || defined(MODE_VBE2_DIRECT)
+// Display start (4F07h) flipping between LFB pages
+int vesaflip;
+#endif
+
+//
+// Frame time distribution
+// Frame times are PIT clocks read through TS_GetClock.
+// The last FRAMETIMES frames give the overlay figures,
+// the histogram of the whole level goes to the log.
+//
+#define FRAMETIMES 128
+#define FRAMETIMEBINS 101 // 1 ms each, the last one holds 100 ms or more
+
+static unsigned int frametimes[FRAMETIMES];
+static byte frameio[FRAMETIMES];
+static int frameindex;
+static int framecount;
+static unsigned int framehistogram[FRAMETIMEBINS];
+static unsigned int framehistogramio[FRAMETIMEBINS];
+
+unsigned int frametimemedian;
+unsigned int frametimelow;
+unsigned int frametimemax;
+int frametimeio;
+
+static int I_CompareFrameTimes(const void *a, const void *b)
+{
+    return *(unsigned int *)a < *(unsigned int *)b ? -1 : *(unsigned int *)a > *(unsigned int *)b;
+}
+
+void I_UpdateFrameTime(void)
+{
+    static unsigned long lastclock;
+    static int lastreads, lastpurges;
+    static unsigned int sorted[FRAMETIMES];
+    unsigned long clock;
+    unsigned int frametime;
+    int bin;
+    int i;
+
+    clock = TS_GetClock();
+    frametime = clock - lastclock;
+    lastclock = clock;
+
+    // a disk read or a zone purge during the frame
+    frameio[frameindex] = lumpreads != lastreads || zonepurges != lastpurges;
+    lastreads = lumpreads;
+    lastpurges = zonepurges;
+
+    frametimes[frameindex] = frametime;
+    frameindex = (frameindex + 1) & (FRAMETIMES - 1);
+
+    // the first frame has no start
+    if (framecount++ == 0)
+        return;
+
+    bin = frametime / PITCLOCKSPERMS;
+    if (bin >= FRAMETIMEBINS)
+        bin = FRAMETIMEBINS - 1;
+
+    framehistogram[bin]++;
+    framehistogramio[bin] += frameio[(frameindex - 1) & (FRAMETIMES - 1)];
+
+    if (framecount < FRAMETIMES || (frameindex & 15))
+        return;
+
+    memcpy(sorted, frametimes, sizeof(sorted));
+    qsort(sorted, FRAMETIMES, sizeof(unsigned int), I_CompareFrameTimes);
+
+    frametimemedian = sorted[FRAMETIMES / 2];
+    frametimelow = sorted[FRAMETIMES - 1 - FRAMETIMES / 100];
+    frametimemax = sorted[FRAMETIMES - 1];
+
+    frametimeio = 0;
+    for (i = 0; i < FRAMETIMES; i++)
+        frametimeio += frameio[i];
+}
+
+//
+// I_LogFrameTimes
+// Appends the frame time histogram to frametim.txt and starts a new one.
+//
+void I_LogFrameTimes(void)
+{
+    FILE *logFile;
+    int i;
+
+    if (!showFrameTime || framecount < 2)
+        return;
+
+    logFile = fopen("frametim.txt", "a");
+    if (logFile)
+    {
+        fprintf(logFile, "# E%iM%i, %i frames, median %i.%i ms, 1%% low %i.%i ms, max %i.%i ms\n",
+                gameepisode, gamemap, framecount - 1,
+                frametimemedian / PITCLOCKSPERMS, Mul10(frametimemedian % PITCLOCKSPERMS) / PITCLOCKSPERMS,
+                frametimelow / PITCLOCKSPERMS, Mul10(frametimelow % PITCLOCKSPERMS) / PITCLOCKSPERMS,
+                frametimemax / PITCLOCKSPERMS, Mul10(frametimemax % PITCLOCKSPERMS) / PITCLOCKSPERMS);
+        fprintf(logFile, "# ms,frames,frames_with_io\n");
+
+        for (i = 0; i < FRAMETIMEBINS; i++)
+        {
+            if (framehistogram[i])
+                fprintf(logFile, "%i,%u,%u\n", i, framehistogram[i], framehistogramio[i]);
+        }
+
+        fclose(logFile);
+    }
+
+    memset(framehistogram, 0, sizeof(framehistogram));
+    memset(framehistogramio, 0, sizeof(framehistogramio));
+    framecount = 0;
+}
+
+#if defined(MODE_13H) || defined(MODE_VBE2)
+//
+// I_BlitBackbuffer
+// Copies the view window, the message rows and the damaged status
+// bar rectangles, a row at a time with rep movsd so video memory
+// only sees aligned sequential dword writes.
+//
+void I_BlitBackbuffer(byte *dest, int state, damagerect_t *rects, int count)
+{
+    int i;
+    int x, w, y, yend;
+
+    if (state & I_FULLSCRN)
+    {
+        CopyDWords(backbuffer, dest, SCREENHEIGHT * SCREENWIDTH / 4);
+        return;
+    }
+
+    if (state & I_FULLVIEW)
+    {
+        for (i = startscreen; i < endscreen; i += SCREENWIDTH)
+        {
+            CopyDWords(backbuffer + i, dest + i, scaledviewwidth / 4);
+        }
+    }
+
+    if (state & I_STATBAR)
+    {
+        if (!count)
+        {
+            i = Mul320(SCREENHEIGHT - SBARHEIGHT);
+            CopyDWords(backbuffer + i, dest + i, Mul80(SBARHEIGHT));
+        }
+
+        for (; count > 0; count--, rects++)
+        {
+            // Widen to dword boundaries
+            x = rects->x & ~3;
+            w = (rects->x + rects->w + 3 - x) >> 2;
+            yend = Mul320(rects->y + rects->h);
+
+            for (y = Mul320(rects->y) + x; y < yend; y += SCREENWIDTH)
+            {
+                CopyDWords(backbuffer + y, dest + y, w);
+            }
+        }
+    }
+
+    if (state & I_MESSAGES)
+    {
+        CopyDWords(backbuffer, dest, (SCREENWIDTH * 28) / 4);
+    }
+}
+#endif
+
+#if defined(MODE_VBE2)
+//
+// Two LFB pages, the frame goes to the hidden one and the
+// display start is moved there. A page last received the
+// frame before the previous one, so it keeps the changes
+// of both until it's shown again.
+//
+int vesapage;
+int pagestate[2];
+damagerect_t pagerects[2][MAXDAMAGE];
+int numpagerects[2];
+
+void VBE2_DrawBackbuffer(void)
+{
+    int i, j;
+
+    if (!vesaflip)
+    {
+        I_BlitBackbuffer(pcscreen, updatestate, damagerects, numdamagerects);
+        return;
+    }
+
+    for (i = 0; i < 2; i++)
+    {
+        pagestate[i] |= updatestate;
+
+        // An empty list means the whole status bar, which the
+        // rectangles of the other frame wouldn't cover
+        if ((updatestate & I_STATBAR) && !numdamagerects)
+        {
+            I_AddDamage(pagerects[i], &numpagerects[i], 0, SCREENHEIGHT - SBARHEIGHT, SCREENWIDTH, SBARHEIGHT);
+        }
+
+        for (j = 0; j < numdamagerects; j++)
+        {
+            I_AddDamage(pagerects[i], &numpagerects[i], damagerects[j].x, damagerects[j].y, damagerects[j].w, damagerects[j].h);
+        }
+    }
+
+    i = vesapage ^ 1;
+
+    I_BlitBackbuffer(pcscreen + i * SCREENWIDTH * SCREENHEIGHT, pagestate[i], pagerects[i], numpagerects[i]);
+    VBE_SetDisplayStart_Y(i * SCREENHEIGHT);
+
+    pagestate[i] = I_NOUPDATE;
+    numpagerects[i] = 0;
+    vesapage = i;
+}
+#endif
+
+#ifdef MODE_Y
+//
+// Triple buffering
+// The CRTC takes a new start address at the next vertical retrace,
+// so I_FinishUpdate only writes it and returns. The page drawn next
+// was on screen until the flip before that one, drawing only waits
+// when no retrace has passed since then.
+//
+unsigned long vblperiod;
+unsigned long flipclock[2];
+byte flipretrace[2];
+
+void I_MeasureVBL(void)
+{
+    unsigned long start;
+
+    I_WaitSingleVBL();
+    start = TS_GetClock();
+    I_WaitSingleVBL();
+    I_WaitSingleVBL();
+    I_WaitSingleVBL();
+    I_WaitSingleVBL();
+    vblperiod = (TS_GetClock() - start) / 4;
+
+    // Err on the long side
+    vblperiod += vblperiod / 32;
+}
+
+void I_WaitFreePage(void)
+{
+    if (!waitVsync)
+        return;
+
+    // Flipped during a retrace, that one didn't count
+    if (flipretrace[1])
+    {
+        while ((inp(0x3DA) & 0x08) && TS_GetClock() - flipclock[1] < vblperiod)
+            ;
+    }
+
+    while (!(inp(0x3DA) & 0x08) && TS_GetClock() - flipclock[1] < vblperiod)
+        ;
+}
+#endif
+
 void I_FinishUpdate(void)
 {
     static int fps_counter, fps_starttime, fps_nextcalculation;
     int opt1, opt2;
 
-#if !defined(MODE_HERC) && !defined(MODE_MDA)
+#if !defined(MODE_HERC) && !defined(MODE_MDA) && !defined(MODE_Y)
     if (waitVsync)
         I_WaitSingleVBL();
 #endif
@@ -3214,6 +3655,14 @@ void I_FinishUpdate(void)
 #ifdef MODE_Y
     outpw(CRTC_INDEX, ((int)destscreen & 0xff00) + 0xc);
 
+    if (waitVsync)
+    {
+        flipclock[1] = flipclock[0];
+        flipretrace[1] = flipretrace[0];
+        flipclock[0] = TS_GetClock();
+        flipretrace[0] = inp(0x3DA) & 0x08;
+    }
+
     // Next plane
     if (destscreen == (byte *)0xA8000)
         destscreen = (byte *)0xA0000;
@@ -3221,57 +3670,30 @@ void I_FinishUpdate(void)
         destscreen += 0x4000;
 #endif
 #ifdef MODE_VBE2_DIRECT
-    VBE_SetDisplayStart_Y(page);
-
-    if (page == 400)
-    {
-        page = 0;
-        destscreen -= 2 * 320 * 200;
-    }
-    else
+    if (vesaflip)
     {
-        page += 200;
-        destscreen += 320 * 200;
-    }
-#endif
-#if defined(MODE_13H) || defined(MODE_VBE2)
+        VBE_SetDisplayStart_Y(page);
 
-    if (updatestate & I_FULLSCRN)
-    {
-        CopyDWords(backbuffer, pcscreen, SCREENHEIGHT * SCREENWIDTH / 4);
-        updatestate = I_NOUPDATE; // clear out all draw types
-    }
-    if (updatestate & I_FULLVIEW)
-    {
-        if (updatestate & I_MESSAGES && screenblocks > 7)
+        if (page == 400)
         {
-            int i;
-            for (i = 0; i < endscreen; i += SCREENWIDTH)
-            {
-                CopyDWords(backbuffer + i, pcscreen + i, SCREENWIDTH / 4);
-            }
-            updatestate &= ~(I_FULLVIEW | I_MESSAGES);
+            page = 0;
+            destscreen -= 2 * 320 * 200;
         }
         else
         {
-            int i;
-            for (i = startscreen; i < endscreen; i += SCREENWIDTH)
-            {
-                CopyDWords(backbuffer + i, pcscreen + i, SCREENWIDTH / 4);
-            }
-            updatestate &= ~I_FULLVIEW;
+            page += 200;
+            destscreen += 320 * 200;
         }
     }
-    if (updatestate & I_STATBAR)
-    {
-        CopyDWords(backbuffer + SCREENWIDTH * (SCREENHEIGHT - SBARHEIGHT), pcscreen + SCREENWIDTH * (SCREENHEIGHT - SBARHEIGHT), SCREENWIDTH * SBARHEIGHT / 4);
-        updatestate &= ~I_STATBAR;
-    }
-    if (updatestate & I_MESSAGES)
-    {
-        CopyDWords(backbuffer, pcscreen, (SCREENWIDTH * 28) / 4);
-        updatestate &= ~I_MESSAGES;
-    }
+#endif
+#if defined(MODE_13H)
+    I_BlitBackbuffer(pcscreen, updatestate, damagerects, numdamagerects);
+#endif
+#if defined(MODE_VBE2)
+    VBE2_DrawBackbuffer();
+#endif
+#if defined(USE_DIRTYROWS)
+    I_DirtyRows();
 #endif
 #ifdef MODE_HERC
     HERC_DrawBackbuffer();
@@ -3340,6 +3762,11 @@ void I_FinishUpdate(void)
     V2_DrawBackbuffer();
 #endif
 
+#if defined(USE_BACKBUFFER)
+    updatestate = I_NOUPDATE;
+    numdamagerects = 0;
+#endif
+
     if (showFPS)
     {
         if (fps_counter == 0)
@@ -3361,6 +3788,9 @@ void I_FinishUpdate(void)
             fps_counter = 0; // flush old data
         }
     }
+
+    if (showFrameTime)
+        I_UpdateFrameTime();
 }
 
 // Test VGA REP OUTSB capability
@@ -3547,6 +3977,8 @@ void I_InitGraphics(void)
     outp(CRTC_INDEX, CRTC_MODE);
     outp(CRTC_INDEX + 1, inp(CRTC_INDEX + 1) | 0x40);
     outp(GC_INDEX, GC_READMAP);
+
+    I_MeasureVBL();
 #endif
 
 #if defined(MODE_V2)
@@ -4095,8 +4527,18 @@ void I_InitGraphics(void)
     // If a VESA compatible 320x200 8bpp mode is found, use it!
     if (vesavideomode != 0xFFFF)
     {
+#if defined(MODE_VBE2)
+        vesaflip = vesalinear == 1 && vbemode.NumberOfImagePages >= 1 && vbeinfo.TotalMemory >= 2;
+#else
+        vesaflip = vesalinear == 1 && vbemode.NumberOfImagePages >= 2 && vbeinfo.TotalMemory >= 4;
+#endif
+
         VBE_SetMode(vesavideomode, vesalinear, 1);
 
+        // The BIOS may still refuse 4F07h
+        if (vesaflip && !VBE_IsDisplayStartSupported())
+            vesaflip = 0;
+
         if (vesalinear == 1)
         {
             pcscreen = destscreen = VBE_GetVideoPtr(vesavideomode);
@@ -4147,6 +4589,23 @@ void I_ShutdownGraphics(void)
 
     regs.w.ax = 3;
     int386(0x10, &regs, &regs); // back to text mode
+
+#if defined(MODE_VBE2) || defined(MODE_VBE2_DIRECT)
+    // 4F07h can only be probed once the VBE mode is set,
+    // so the outcome is reported back in text mode
+    if (vesavideomode != 0xFFFF)
+    {
+        if (vesaflip)
+            printf("I_ShutdownGraphics: VBE page flipping (4F07h) was used\n");
+#if defined(MODE_VBE2)
+        else
+            printf("I_ShutdownGraphics: no VBE page flipping, copied to the visible page\n");
+#else
+        else
+            printf("I_ShutdownGraphics: no VBE page flipping, drew to the visible page\n");
+#endif
+    }
+#endif
 }
 
 //
@@ -4236,9 +4695,28 @@ void I_StartTic(void)
 //
 // I_TimerISR
 //
+unsigned long ticclock;
+
 void I_TimerISR(task *task)
 {
     ticcount++;
+    ticclock = TS_GetClock();
+}
+
+//
+// I_GetTicFrac
+// How far into the current tic the timer is, 0 to FRACUNIT
+//
+#define TICCLOCKS (1193182 / TICRATE)
+
+fixed_t I_GetTicFrac(void)
+{
+    unsigned long elapsed = TS_GetClock() - ticclock;
+
+    if (elapsed >= TICCLOCKS)
+        return FRACUNIT;
+
+    return (elapsed << FRACBITS) / TICCLOCKS;
 }
 
 //
@@ -4385,6 +4863,38 @@ void I_StartupDPMI(void)
     DPMI_LockMemory(&__begtext, &___Argc - &__begtext);
 }
 
+//
+// I_DetectCPU
+// 386s can't flip the AC flag, early 486s can't flip ID,
+// anything with CPUID reports its family
+//
+cputype_t selectedCPU;
+
+void I_DetectCPU(void)
+{
+    int p;
+
+    p = M_CheckParm("-cpu");
+    if (p && p < myargc - 1)
+    {
+        selectedCPU = atoi(myargv[p + 1]) / 100;
+        if (selectedCPU < cpu_386)
+            selectedCPU = cpu_386;
+        else if (selectedCPU > cpu_pentium)
+            selectedCPU = cpu_pentium;
+    }
+    else if (!I_EFlagsToggle(EFLAGS_AC))
+        selectedCPU = cpu_386;
+    else if (!I_EFlagsToggle(EFLAGS_ID))
+        selectedCPU = cpu_486;
+    else if (I_CPUIDFamily() >= 5)
+        selectedCPU = cpu_pentium;
+    else
+        selectedCPU = cpu_486;
+
+    printf("I_DetectCPU: %s class CPU\n", selectedCPU == cpu_386 ? "386" : selectedCPU == cpu_486 ? "486" : "Pentium");
+}
+
 //
 // I_Init
 // hook interrupts and set graphics mode
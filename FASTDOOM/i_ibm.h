@@ -1,3 +1,6 @@
+#ifndef __I_IBM__
+#define __I_IBM__
+
 #include "fastmath.h"
 #include "ns_task.h"
 #include "doomtype.h"
@@ -6,6 +9,15 @@
 extern int ticcount;
 extern fixed_t fps;
 
+fixed_t I_GetTicFrac(void);
+
+extern unsigned int frametimemedian;
+extern unsigned int frametimelow;
+extern unsigned int frametimemax;
+extern int frametimeio;
+
+void I_LogFrameTimes(void);
+
 extern unsigned short *currentscreen;
 
 #if defined(MODE_Y) || defined(MODE_13H) || defined(MODE_VBE2) || defined(MODE_VBE2_DIRECT) || defined(MODE_V2)
@@ -30,6 +42,19 @@ extern byte *ptrlutIcolor;
 
 #if defined(USE_BACKBUFFER)
 extern int updatestate;
+
+#define MAXDAMAGE 16
+
+typedef struct
+{
+    short x;
+    short y;
+    short w;
+    short h;
+} damagerect_t;
+
+// Marks a status bar rectangle for the next update
+void I_DirtyStatBar(int x, int y, int w, int h);
 #endif
 
 #define I_NOUPDATE	0
@@ -39,3 +64,5 @@ extern int updatestate;
 #define I_FULLSCRN	8
 
 extern void I_TimerISR(task *task);
+
+#endif
@@ -36,6 +36,7 @@
 #include "ns_task.h"
 #include "ns_music.h"
 #include "ns_cms.h"
+#include "ns_disk.h"
 
 #include "options.h"
 
@@ -48,6 +49,7 @@ task *tsm_task;
 void I_StartupTimer(void)
 {
     printf("I_StartupTimer()\n");
+    TS_Stats = taskStats;
     // installs master timer.  Must be done before StartupTimer()!
     tsm_task = TS_ScheduleTask(I_TimerISR, 35, 1, NULL);
     TS_Dispatch();
@@ -55,12 +57,27 @@ void I_StartupTimer(void)
 
 void I_ShutdownTimer(void)
 {
+    int i;
+    unsigned long us, share;
+
     if (tsm_task)
     {
         TS_Terminate(tsm_task);
     }
     tsm_task = NULL;
     TS_Shutdown();
+
+    for (i = 0; i < TS_NumStats; i++)
+    {
+        taskstats *stats = &TS_StatsTable[i];
+
+        // Microseconds per call, and hundredths of a percent of the task's lifetime
+        us = stats->clocks / PITCLOCKSPERMS * 1000 + (stats->clocks % PITCLOCKSPERMS) * 1000 / PITCLOCKSPERMS;
+        share = stats->lifetime >= 10000 ? stats->clocks / (stats->lifetime / 10000) : 0;
+
+        printf("Task %5ld Hz: %lu calls, %lu us per call, %lu.%02lu%% of the time\n",
+               stats->rate, stats->calls, us / stats->calls, share / 100, share % 100);
+    }
 }
 
 //
@@ -89,7 +106,7 @@ void I_SetMusicVolume(int volume)
 //
 int I_GetSfxLumpNum(sfxinfo_t *sfx)
 {
-    const char snd_prefixen[] = {'P', 'P', 'A', 'S', 'S', 'S', 'M', 'M', 'M', 'S', 'S', 'S', 'S', 'S', 'S', 'S', 'S', 'S', 'S', 'S', 'A', 'A'};
+    const char snd_prefixen[] = {'P', 'P', 'A', 'S', 'S', 'S', 'M', 'M', 'M', 'S', 'S', 'S', 'S', 'S', 'S', 'S', 'S', 'S', 'S', 'S', 'A', 'A', 'S'};
     char namebuf[9];
     sprintf(namebuf, "D%c%s", snd_prefixen[snd_SfxDevice], sfx->name);
     return W_GetNumForName(namebuf);
@@ -101,7 +118,7 @@ int I_GetSfxLumpNum(sfxinfo_t *sfx)
 
 void I_sndArbitrateCards(void)
 {
-    byte gus, adlib, sb, midi, ensoniq, lpt, cmsfx, cmsmus, oplxlpt;
+    byte gus, adlib, sb, midi, ensoniq, lpt, cmsfx, cmsmus, oplxlpt, disk;
     int dmxlump;
 
     snd_SfxVolume = 127;
@@ -129,6 +146,18 @@ void I_sndArbitrateCards(void)
         snd_MusicDevice = snd_MPU;
     }
 
+    //
+    // the file device renders everything offline, it can't be mixed
+    // with real cards
+    //
+    if (M_CheckParm("-disksound") || snd_SfxDevice == snd_DISK || snd_MusicDevice == snd_DISK)
+    {
+        if (snd_SfxDevice != snd_none)
+            snd_SfxDevice = snd_DISK;
+        if (snd_MusicDevice != snd_none)
+            snd_MusicDevice = snd_DISK;
+    }
+
     //
     // figure out what i've got to initialize
     //
@@ -136,11 +165,12 @@ void I_sndArbitrateCards(void)
     sb = snd_SfxDevice == snd_SB || snd_SfxDevice == snd_SBDirect;
     ensoniq = snd_SfxDevice == snd_ENSONIQ;
     adlib = snd_MusicDevice == snd_Adlib || snd_MusicDevice == snd_SB || snd_MusicDevice == snd_PAS;
-    oplxlpt = snd_MusicDevice == snd_OPL2LPT || snd_MusicDevice == snd_OPL3LPT;
+    oplxlpt = snd_MusicDevice == snd_OPL2LPT || snd_MusicDevice == snd_OPL3LPT || snd_MusicDevice == snd_DISK;
     midi = snd_MusicDevice == snd_MPU;
     lpt = snd_SfxDevice == snd_DISNEY || snd_SfxDevice == snd_TANDY || snd_SfxDevice == snd_LPTDAC;
     cmsfx = snd_SfxDevice == snd_CMS;
     cmsmus = snd_MusicDevice == snd_CMS;
+    disk = snd_MusicDevice == snd_DISK || snd_SfxDevice == snd_DISK;
 
     //
     // initialize whatever i've got
@@ -225,6 +255,12 @@ void I_sndArbitrateCards(void)
         CMS_SetCard(snd_Mport);
     }
 
+    if (disk)
+    {
+        // music and sound tasks run from the game tics
+        TS_VirtualClock = true;
+    }
+
     if (cmsfx && cmsmus)
     {
         CMS_SetMode(CMS_MusicFX);
@@ -272,6 +308,31 @@ void I_StartupSound(void)
 //
 void I_ShutdownSound(void)
 {
+    unsigned long mixus, audioms;
+
     S_PauseSound();
     ASS_DeInit();
+
+    if (snd_SfxDevice == snd_DISK)
+    {
+        // Microseconds spent mixing and milliseconds of audio,
+        // divided in tenths of a second to stay within 32 bits
+        mixus = DISK_MixClocks / PITCLOCKSPERMS * 1000 + (DISK_MixClocks % PITCLOCKSPERMS) * 1000 / PITCLOCKSPERMS;
+        audioms = DISK_Samples / DISK_SampleRate * 1000 + (DISK_Samples % DISK_SampleRate) * 1000 / DISK_SampleRate;
+
+        if (audioms >= 100)
+            printf("Mixer: %lu us per second of audio\n", mixus * 10 / (audioms / 100));
+    }
+}
+
+//
+// I_UpdateSound
+// Renders the file device up to the current game tic
+//
+void I_UpdateSound(void)
+{
+    if (TS_VirtualClock)
+    {
+        DISK_Update(gametic);
+    }
 }
@@ -27,6 +27,52 @@
 // Called by DoomMain.
 void I_Init(void);
 
+// Processor class, picks the drawers
+//  scheduled best for it
+typedef enum
+{
+    cpu_386 = 3,
+    cpu_486,
+    cpu_pentium
+} cputype_t;
+
+extern cputype_t selectedCPU;
+
+// Called by DoomMain before R_Init.
+void I_DetectCPU(void);
+
+#define EFLAGS_AC 0x40000
+#define EFLAGS_ID 0x200000
+
+// Returns the EFLAGS bits in mask that can be flipped
+int I_EFlagsToggle(int mask);
+#pragma aux I_EFlagsToggle = \
+    "pushfd", \
+    "pop eax", \
+    "mov ecx, eax", \
+    "xor eax, edx", \
+    "push eax", \
+    "popfd", \
+    "pushfd", \
+    "pop eax", \
+    "push ecx", \
+    "popfd", \
+    "xor eax, ecx", \
+    "and eax, edx" parm[edx] value[eax] modify exact[eax ecx]
+
+// CPUID function 1 family, cpuid emitted as bytes for 386 targets
+int I_CPUIDFamily(void);
+#pragma aux I_CPUIDFamily = \
+    "mov eax, 1", \
+    0x0f, 0xa2, \
+    "shr eax, 8", \
+    "and eax, 15" value[eax] modify exact[eax ebx ecx edx]
+
+// Low half of the time stamp counter, Pentium and later only
+unsigned int I_ReadTSC(void);
+#pragma aux I_ReadTSC = \
+    0x0f, 0x31 value[eax] modify exact[eax edx]
+
 // Called by startup code
 // to get the ammount of memory to malloc
 // for the zone management.
@@ -63,6 +109,7 @@ void I_LoopSong(int handle);
 // an endless loop.  the start is faded in over three seconds.
 
 void I_SetMusicVolume(int volume);
+void I_UpdateSound(void);
 void I_ResumeSong(int handle);
 
 //  SFX I/O
@@ -90,6 +137,10 @@ void I_SetPalette(int numpalette);
 #if defined(MODE_Y) || defined(MODE_VBE2_DIRECT)
 void I_UpdateNoBlit(void);
 #endif
+#ifdef MODE_Y
+// Waits until the page about to be drawn left the screen
+void I_WaitFreePage(void);
+#endif
 void I_FinishUpdate(void);
 
 // Wait for vertical retrace or pause a bit.
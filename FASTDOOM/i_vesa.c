@@ -204,6 +204,17 @@ void VBE_SetDisplayStart_Y(short y)
   RMIRQ10();
 }
 
+int VBE_IsDisplayStartSupported(void)
+{
+  PrepareRegisters();
+  RMI.EAX = 0x00004f07;
+  RMI.EBX = 0;
+  RMI.ECX = 0;
+  RMI.EDX = 0;
+  RMIRQ10();
+  return ((RMI.EAX & 0xffff) == 0x004f);
+}
+
 void setbiosmode(unsigned short c);
 #pragma aux setbiosmode = "int 0x10" parm[ax] modify[eax ebx ecx edx esi edi];
 
@@ -265,6 +265,13 @@ void VBE_SetDisplayStart_Y (short y);
   * (for scrolling & page flipping)
   */
 
+int VBE_IsDisplayStartSupported(void);
+
+/*
+  * Returns nonzero if the BIOS accepts display start changes (4F07h)
+  * in the current mode. Resets the display start to 0,0
+  */
+
 void VBE_SetDACWidth(char bits);
 
 /*
@@ -208,3 +208,263 @@ CODE_SYM_DEF R_DrawSpan_13h
 %endrep
 
 hmap320: ret
+
+; ========================
+; R_DrawColumnPentium_13h
+; ========================
+; Two pixels per iteration for the Pentium U/V pipes,
+; the step and position stay in ecx/edx and both eax and
+; ebx carry the colormap, so the pixels never share a register
+
+CONTINUE_DATA_SECTION
+
+colend:      dd 0
+spanend:     dd 0
+
+CONTINUE_CODE_SECTION
+
+CODE_SYM_DEF R_DrawColumnPentium_13h
+  pushad
+
+  mov  eax,[_dc_yl]
+  mov  ebp,[_dc_yh]
+  mov  ebx,[_dc_x]
+  sub  ebp,eax              ; ebp = pixel count - 1
+  js   short .done
+  mov  edi,[_ylookup+eax*4]
+  mov  ecx,[_dc_iscale]
+  add  edi,[_columnofs+ebx*4]
+
+  sub  eax,[_centery]
+  imul ecx
+  mov  edx,[_dc_texturemid]
+  shl  ecx,9 ; 7 significant bits, 25 frac
+  add  edx,eax
+  lea  ebp,[ebp+ebp*4]
+  shl  edx,9 ; 7 significant bits, 25 frac
+  shl  ebp,6
+  mov  esi,[_dc_source]
+  add  ebp,edi              ; ebp = bottom pixel
+  mov  eax,[_dc_colormap]
+  mov  [colend],ebp
+  mov  ebx,eax
+  cmp  edi,ebp
+  jae  short .last
+
+.loop:
+  mov  ebp,edx
+  add  edx,ecx              ; calculate next location
+  shr  ebp,25
+  add  edi,SCREENWIDTH*2
+  mov  al,[esi+ebp]         ; get first source pixel
+  mov  ebp,edx
+  shr  ebp,25
+  add  edx,ecx
+  mov  bl,[esi+ebp]         ; get second source pixel
+  mov  al,[eax]             ; translate both colors
+  mov  bl,[ebx]
+  mov  [edi-SCREENWIDTH*2],al
+  mov  [edi-SCREENWIDTH],bl
+  cmp  edi,[colend]
+  jb   short .loop
+  ja   short .done          ; even count, nothing left
+
+.last:
+  shr  edx,25
+  mov  al,[esi+edx]
+  mov  al,[eax]
+  mov  [edi],al
+
+.done:
+  popad
+  ret
+; R_DrawColumnPentium_13h ends
+
+; ======================
+; R_DrawSpanPentium_13h
+; ======================
+; Same 6.10/6.10 position as R_DrawSpan_13h, but the
+; texel address is built without shld or a patched ret,
+; both of which stall the Pentium pipes. Two pixels
+; per iteration, the step stays in edx
+
+CODE_SYM_DEF R_DrawSpanPentium_13h
+  pushad
+
+  mov     eax,[_ds_y]
+  mov     ebx,[_ds_x1]
+  mov     edi,[_ylookup+eax*4]
+  mov     ebp,[_ds_x2]
+  add     edi,[_columnofs]
+  sub     ebp,ebx               ; ebp = pixel count - 1
+  js      short .done
+  add     edi,ebx               ; edi = first pixel of the span
+  mov     ecx,[_ds_frac]
+  add     ebp,edi               ; ebp = last pixel of the span
+  mov     edx,[_ds_step]
+  mov     [spanend],ebp
+  mov     esi,[_ds_source]
+  mov     eax,[_ds_colormap]
+  cmp     edi,ebp
+  jae     short .last
+
+.loop:
+  mov     ebx,ecx
+  mov     ebp,ecx
+  shr     ebx,26                ; x units
+  and     ebp,0xFC00            ; y units
+  shr     ebp,4
+  add     ecx,edx               ; position += step
+  or      ebx,ebp
+  mov     ebp,ecx
+  mov     al,[esi+ebx]          ; get first source pixel
+  mov     ebx,ecx
+  shr     ebx,26
+  and     ebp,0xFC00
+  shr     ebp,4
+  add     ecx,edx
+  mov     al,[eax]              ; translate color
+  or      ebx,ebp
+  mov     [edi],al              ; write first pixel
+  add     edi,2
+  mov     al,[esi+ebx]          ; get second source pixel
+  mov     al,[eax]
+  mov     [edi-1],al
+  cmp     edi,[spanend]
+  jb      short .loop
+  ja      short .done           ; even count, nothing left
+
+.last:
+  mov     ebx,ecx
+  shr     ebx,26
+  and     ecx,0xFC00
+  shr     ecx,4
+  or      ebx,ecx
+  mov     al,[esi+ebx]
+  mov     al,[eax]
+  mov     [edi],al
+
+.done:
+  popad
+  ret
+; R_DrawSpanPentium_13h ends
+
+; ==========================
+; R_DrawColumnUnmapped_13h
+; ==========================
+; R_DrawColumnPentium_13h for sources already run through
+; the fixed colormap, there is no color to translate
+
+CODE_SYM_DEF R_DrawColumnUnmapped_13h
+  pushad
+
+  mov  eax,[_dc_yl]
+  mov  ebp,[_dc_yh]
+  mov  ebx,[_dc_x]
+  sub  ebp,eax              ; ebp = pixel count - 1
+  js   short .done
+  mov  edi,[_ylookup+eax*4]
+  mov  ecx,[_dc_iscale]
+  add  edi,[_columnofs+ebx*4]
+
+  sub  eax,[_centery]
+  imul ecx
+  mov  edx,[_dc_texturemid]
+  shl  ecx,9 ; 7 significant bits, 25 frac
+  add  edx,eax
+  lea  ebp,[ebp+ebp*4]
+  shl  edx,9 ; 7 significant bits, 25 frac
+  shl  ebp,6
+  mov  esi,[_dc_source]
+  add  ebp,edi              ; ebp = bottom pixel
+  mov  [colend],ebp
+  cmp  edi,ebp
+  jae  short .last
+
+.loop:
+  mov  eax,edx
+  add  edx,ecx              ; calculate next location
+  shr  eax,25
+  mov  ebx,edx
+  shr  ebx,25
+  add  edx,ecx
+  mov  al,[esi+eax]         ; get first source pixel
+  mov  bl,[esi+ebx]         ; get second source pixel
+  add  edi,SCREENWIDTH*2
+  mov  [edi-SCREENWIDTH*2],al
+  mov  [edi-SCREENWIDTH],bl
+  cmp  edi,[colend]
+  jb   short .loop
+  ja   short .done          ; even count, nothing left
+
+.last:
+  shr  edx,25
+  mov  al,[esi+edx]
+  mov  [edi],al
+
+.done:
+  popad
+  ret
+; R_DrawColumnUnmapped_13h ends
+
+; ========================
+; R_DrawSpanUnmapped_13h
+; ========================
+; R_DrawSpanPentium_13h without the color translation
+
+CODE_SYM_DEF R_DrawSpanUnmapped_13h
+  pushad
+
+  mov     eax,[_ds_y]
+  mov     ebx,[_ds_x1]
+  mov     edi,[_ylookup+eax*4]
+  mov     ebp,[_ds_x2]
+  add     edi,[_columnofs]
+  sub     ebp,ebx               ; ebp = pixel count - 1
+  js      short .done
+  add     edi,ebx               ; edi = first pixel of the span
+  mov     ecx,[_ds_frac]
+  add     ebp,edi               ; ebp = last pixel of the span
+  mov     edx,[_ds_step]
+  mov     [spanend],ebp
+  mov     esi,[_ds_source]
+  cmp     edi,ebp
+  jae     short .last
+
+.loop:
+  mov     ebx,ecx
+  mov     ebp,ecx
+  shr     ebx,26                ; x units
+  and     ebp,0xFC00            ; y units
+  shr     ebp,4
+  add     ecx,edx               ; position += step
+  or      ebx,ebp
+  mov     ebp,ecx
+  mov     al,[esi+ebx]          ; get first source pixel
+  mov     ebx,ecx
+  shr     ebx,26
+  and     ebp,0xFC00
+  shr     ebp,4
+  add     ecx,edx
+  or      ebx,ebp
+  mov     [edi],al              ; write first pixel
+  add     edi,2
+  mov     al,[esi+ebx]          ; get second source pixel
+  mov     [edi-1],al
+  cmp     edi,[spanend]
+  jb      short .loop
+  ja      short .done           ; even count, nothing left
+
+.last:
+  mov     ebx,ecx
+  shr     ebx,26
+  and     ecx,0xFC00
+  shr     ecx,4
+  or      ebx,ecx
+  mov     al,[esi+ebx]
+  mov     [edi],al
+
+.done:
+  popad
+  ret
+; R_DrawSpanUnmapped_13h ends
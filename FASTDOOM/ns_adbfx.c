@@ -31,8 +31,6 @@ static int ADBFX_CurrentLength = 0;
 static char *ADBFX_SoundPtr;
 volatile int ADBFX_SoundPlaying;
 
-static task *ADBFX_Timer;
-
 void (*ADBFX_CallBack)(void);
 
 /*---------------------------------------------------------------------
@@ -74,7 +72,7 @@ const unsigned char LUTdb[256] = {
     1, 1, 1, 1, 1, 1, 1, 0, 0,
     0, 0, 0, 0, 0, 0, 0, 0, 0};
 
-static void ADBFX_ServiceInterrupt(task *Task)
+static void ADBFX_ServiceInterrupt(void)
 {
     unsigned char value = LUTdb[(unsigned char)(*ADBFX_SoundPtr)];
 
@@ -115,7 +113,7 @@ void ADBFX_StopPlayback(void)
 {
     if (ADBFX_SoundPlaying)
     {
-        TS_Terminate(ADBFX_Timer);
+        TS_SetSampleService(NULL, 0);
         ADBFX_SoundPlaying = 0;
         ADBFX_BufferStart = NULL;
 
@@ -153,8 +151,7 @@ int ADBFX_BeginBufferedPlayback(
 
     ADBFX_SoundPlaying = 1;
 
-    ADBFX_Timer = TS_ScheduleTask(ADBFX_ServiceInterrupt, ADBFX_SampleRate, 1, NULL);
-    TS_Dispatch();
+    TS_SetSampleService(ADBFX_ServiceInterrupt, ADBFX_SampleRate);
 
     return (ADBFX_Ok);
 }
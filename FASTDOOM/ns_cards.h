@@ -26,6 +26,7 @@ typedef enum
    CMS,
    OPL2LPT,
    OPL3LPT,
+   DiskWriter,
    NumSoundCards
 } soundcardnames;
 
@@ -50,8 +50,6 @@ unsigned short CMS_Port = 0x220;
 static short *CMS_SoundPtr;
 volatile int CMS_SoundPlaying;
 
-static task *CMS_Timer;
-
 void (*CMS_CallBack)(void);
 
 // CMS synth
@@ -192,7 +190,7 @@ static void CMS_Reset(void)
     CMS_SetRegister(port + 2, 0x1C, 0x01);
 }
 
-static void CMS_ServiceInterrupt(task *Task)
+static void CMS_ServiceInterrupt(void)
 {   
     char *ptr = CMS_SoundPtr;
 
@@ -240,7 +238,7 @@ void CMS_StopPlayback(void)
 {
     if (CMS_SoundPlaying)
     {
-        TS_Terminate(CMS_Timer);
+        TS_SetSampleService(NULL, 0);
         CMS_SoundPlaying = 0;
         CMS_BufferStart = NULL;
     }
@@ -276,8 +274,7 @@ int CMS_BeginBufferedPlayback(
 
     CMS_SoundPlaying = 1;
 
-    CMS_Timer = TS_ScheduleTask(CMS_ServiceInterrupt, CMS_SampleRate, 1, NULL);
-    TS_Dispatch();
+    TS_SetSampleService(CMS_ServiceInterrupt, CMS_SampleRate);
 
     return (CMS_Ok);
 }
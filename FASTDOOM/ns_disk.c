@@ -0,0 +1,254 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "ns_task.h"
+#include "ns_cards.h"
+#include "ns_disk.h"
+#include "ns_muldf.h"
+
+#include "options.h"
+
+// Renders the mix to a WAV file instead of a sound card. The buffers
+// are played, and the offline tasks (music) run, from a virtual clock
+// that follows the game tics, so the output does not depend on the
+// speed of the machine.
+
+#define DISK_WaveName "sndout.wav"
+#define DISK_TicRate 35
+#define DISK_TimerRate 1193182L
+
+static int DISK_Installed = 0;
+
+static char *DISK_BufferStart;
+static char *DISK_CurrentBuffer;
+static int DISK_BufferNum = 0;
+static int DISK_NumBuffers = 0;
+static int DISK_TransferLength = 0;
+static int DISK_FrameSize = 1;
+static int DISK_Channels = 1;
+
+volatile int DISK_SoundPlaying;
+
+static FILE *DISK_File;
+static unsigned long DISK_ClockFrac;
+static unsigned long DISK_Tics;
+
+unsigned long DISK_Samples;
+unsigned long DISK_MixClocks;
+
+void (*DISK_CallBack)(void);
+
+/*---------------------------------------------------------------------
+   Function: DISK_WriteHeader
+
+   Writes the WAV header for the samples written so far.
+---------------------------------------------------------------------*/
+
+static void DISK_WriteLong(unsigned long value)
+{
+    fputc(value & 0xff, DISK_File);
+    fputc((value >> 8) & 0xff, DISK_File);
+    fputc((value >> 16) & 0xff, DISK_File);
+    fputc((value >> 24) & 0xff, DISK_File);
+}
+
+static void DISK_WriteShort(unsigned value)
+{
+    fputc(value & 0xff, DISK_File);
+    fputc((value >> 8) & 0xff, DISK_File);
+}
+
+static void DISK_WriteHeader(void)
+{
+    unsigned long datasize;
+
+    datasize = DISK_Samples * DISK_FrameSize;
+
+    fseek(DISK_File, 0, SEEK_SET);
+
+    fwrite("RIFF", 1, 4, DISK_File);
+    DISK_WriteLong(36 + datasize);
+    fwrite("WAVEfmt ", 1, 8, DISK_File);
+    DISK_WriteLong(16);
+    DISK_WriteShort(1); // PCM
+    DISK_WriteShort(DISK_Channels);
+    DISK_WriteLong(DISK_SampleRate);
+    DISK_WriteLong(DISK_SampleRate * DISK_FrameSize);
+    DISK_WriteShort(DISK_FrameSize);
+    DISK_WriteShort(8);
+    fwrite("data", 1, 4, DISK_File);
+    DISK_WriteLong(datasize);
+
+    fseek(DISK_File, 0, SEEK_END);
+}
+
+/*---------------------------------------------------------------------
+   Function: DISK_Update
+
+   Plays every buffer due by the given game tic, advancing the virtual
+   clock by the length of each one.
+---------------------------------------------------------------------*/
+
+void DISK_Update(unsigned long tics)
+{
+    unsigned long target;
+    unsigned long frames;
+    unsigned long clocks;
+    unsigned long start;
+
+    if (!DISK_SoundPlaying)
+    {
+        // Music only, step the clock a tic at a time
+        while (DISK_Tics < tics)
+        {
+            DISK_ClockFrac += DISK_TimerRate;
+            clocks = DISK_ClockFrac / DISK_TicRate;
+            DISK_ClockFrac %= DISK_TicRate;
+
+            TS_AdvanceClock(clocks);
+            DISK_Tics++;
+        }
+        return;
+    }
+
+    DISK_Tics = tics;
+
+    target = (tics / DISK_TicRate) * DISK_SampleRate + ((tics % DISK_TicRate) * DISK_SampleRate) / DISK_TicRate;
+    frames = DISK_TransferLength / DISK_FrameSize;
+
+    while (DISK_Samples + frames <= target)
+    {
+        fwrite(DISK_CurrentBuffer, 1, DISK_TransferLength, DISK_File);
+        DISK_Samples += frames;
+
+        // Keep track of current buffer
+        DISK_CurrentBuffer += DISK_TransferLength;
+        DISK_BufferNum++;
+        if (DISK_BufferNum >= DISK_NumBuffers)
+        {
+            DISK_BufferNum = 0;
+            DISK_CurrentBuffer = DISK_BufferStart;
+        }
+
+        DISK_ClockFrac += frames * DISK_TimerRate;
+        clocks = DISK_ClockFrac / DISK_SampleRate;
+        DISK_ClockFrac %= DISK_SampleRate;
+
+        TS_AdvanceClock(clocks);
+
+        // Mix the next buffer
+        if (DISK_CallBack != NULL)
+        {
+            start = TS_GetClock();
+            DISK_CallBack();
+            DISK_MixClocks += TS_GetClock() - start;
+        }
+    }
+}
+
+/*---------------------------------------------------------------------
+   Function: DISK_StopPlayback
+
+   Ends the transfer of digitized sound to the file.
+---------------------------------------------------------------------*/
+
+void DISK_StopPlayback(void)
+{
+    if (DISK_SoundPlaying)
+    {
+        DISK_SoundPlaying = 0;
+        DISK_BufferStart = NULL;
+    }
+}
+
+/*---------------------------------------------------------------------
+   Function: DISK_BeginBufferedPlayback
+
+   Begins multibuffered playback of digitized sound to the file.
+---------------------------------------------------------------------*/
+
+int DISK_BeginBufferedPlayback(
+    char *BufferStart,
+    int BufferSize,
+    int NumDivisions,
+    int MixMode,
+    void (*CallBackFunc)(void))
+{
+    if (DISK_SoundPlaying)
+    {
+        DISK_StopPlayback();
+    }
+
+    DISK_CallBack = CallBackFunc;
+
+    DISK_Channels = (MixMode & STEREO) ? 2 : 1;
+    DISK_FrameSize = DISK_Channels;
+
+    DISK_BufferStart = BufferStart;
+    DISK_CurrentBuffer = BufferStart;
+    DISK_TransferLength = BufferSize / NumDivisions;
+    DISK_BufferNum = 0;
+    DISK_NumBuffers = NumDivisions;
+
+    DISK_SoundPlaying = 1;
+
+    return (DISK_Ok);
+}
+
+/*---------------------------------------------------------------------
+   Function: DISK_Init
+
+   Creates the WAV file and prepares the module to write digitized
+   sounds to it.
+---------------------------------------------------------------------*/
+
+int DISK_Init(int soundcard)
+{
+    if (DISK_Installed)
+    {
+        DISK_Shutdown();
+    }
+
+    DISK_File = fopen(DISK_WaveName, "wb");
+    if (DISK_File == NULL)
+    {
+        return (DISK_Error);
+    }
+
+    DISK_SoundPlaying = 0;
+    DISK_CallBack = NULL;
+    DISK_BufferStart = NULL;
+
+    DISK_Samples = 0;
+    DISK_MixClocks = 0;
+
+    // Room for the header, filled in at shutdown
+    DISK_WriteHeader();
+
+    DISK_Installed = 1;
+
+    return (DISK_Ok);
+}
+
+/*---------------------------------------------------------------------
+   Function: DISK_Shutdown
+
+   Ends transfer of sound data and completes the WAV file.
+---------------------------------------------------------------------*/
+
+void DISK_Shutdown(void)
+{
+    if (!DISK_Installed)
+    {
+        return;
+    }
+
+    DISK_StopPlayback();
+
+    DISK_WriteHeader();
+    fclose(DISK_File);
+    DISK_File = NULL;
+
+    DISK_CallBack = NULL;
+
+    DISK_Installed = 0;
+}
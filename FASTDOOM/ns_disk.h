@@ -0,0 +1,25 @@
+#ifndef __DISK_H
+#define __DISK_H
+
+#define MONO_8BIT 0
+#define STEREO 1
+
+#define DISK_SampleRate 11025
+
+enum DISK_Errors
+{
+    DISK_Warning = -2,
+    DISK_Error = -1,
+    DISK_Ok = 0
+};
+
+extern unsigned long DISK_Samples;
+extern unsigned long DISK_MixClocks;
+
+void DISK_StopPlayback(void);
+int DISK_BeginBufferedPlayback(char *BufferStart, int BufferSize, int NumDivisions, int MixMode, void (*CallBackFunc)(void));
+void DISK_Update(unsigned long tics);
+int DISK_Init(int soundcard);
+void DISK_Shutdown(void);
+
+#endif
@@ -176,6 +176,12 @@ int FX_SetupCard(int SoundCard, fx_device *device, int port)
         device->MaxSampleBits = 8;
         device->MaxChannels = 1;
         break;
+    case DiskWriter:
+        // The file is created when Multivoc starts
+        device->MaxVoices = 8;
+        device->MaxSampleBits = 8;
+        device->MaxChannels = 2;
+        break;
     default:
         status = FX_Error;
     }
@@ -295,6 +301,7 @@ int FX_Init(
     case LPTDAC:
     case AdlibFX:
     case SoundBlasterDirect:
+    case DiskWriter:
         devicestatus = MV_Init(SoundCard, FX_MixRate, numvoices, numchannels, samplebits);
         if (devicestatus != MV_Ok)
         {
@@ -351,6 +358,7 @@ int FX_Shutdown(
     case LPTDAC:
     case AdlibFX:
     case SoundBlasterDirect:
+    case DiskWriter:
         status = MV_Shutdown();
         if (status != MV_Ok)
         {
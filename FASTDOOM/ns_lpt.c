@@ -26,8 +26,6 @@ volatile int LPT_SoundPlaying;
 
 static int LPT_Port = 0x378;
 
-static task *LPT_Timer;
-
 void (*LPT_CallBack)(void);
 
 /*---------------------------------------------------------------------
@@ -37,7 +35,7 @@ void (*LPT_CallBack)(void);
    transfer.  Calls the user supplied callback function.
 ---------------------------------------------------------------------*/
 
-static void LPT_ServiceInterrupt(task *Task)
+static void LPT_ServiceInterrupt(void)
 {
     outp(LPT_Port, *LPT_SoundPtr);
 
@@ -76,7 +74,7 @@ void LPT_StopPlayback(void)
 {
     if (LPT_SoundPlaying)
     {
-        TS_Terminate(LPT_Timer);
+        TS_SetSampleService(NULL, 0);
         LPT_SoundPlaying = 0;
         LPT_BufferStart = NULL;
     }
@@ -112,8 +110,7 @@ int LPT_BeginBufferedPlayback(
 
     LPT_SoundPlaying = 1;
 
-    LPT_Timer = TS_ScheduleTask(LPT_ServiceInterrupt, LPT_SampleRate, 1, NULL);
-    TS_Dispatch();
+    TS_SetSampleService(LPT_ServiceInterrupt, LPT_SampleRate);
 
     return (LPT_Ok);
 }
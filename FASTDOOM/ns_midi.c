@@ -500,6 +500,11 @@ static void _MIDI_ServiceRoutine(task *Task)
         return;
     }
 
+    if (_MIDI_Funcs->StartBatch)
+    {
+        _MIDI_Funcs->StartBatch();
+    }
+
     TimeSet = FALSE;
     Track = _MIDI_TrackPtr;
     tracknum = 0;
@@ -621,6 +626,11 @@ static void _MIDI_ServiceRoutine(task *Task)
         }
     }
 
+    if (_MIDI_Funcs->FlushBatch)
+    {
+        _MIDI_Funcs->FlushBatch();
+    }
+
     _MIDI_AdvanceTick();
 }
 
@@ -1033,6 +1043,7 @@ static void _MIDI_InitEMIDI(
     {
     case SoundBlaster:
     case OPL3LPT:
+    case DiskWriter:
         type = EMIDI_SoundBlaster;
         break;
 
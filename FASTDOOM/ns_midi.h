@@ -33,6 +33,8 @@ typedef struct
     void (*PitchBend)(int channel, int lsb, int msb);
     void (*SetVolume)(int volume);
     int (*GetVolume)(void);
+    void (*StartBatch)(void);
+    void (*FlushBatch)(void);
 } midifuncs;
 
 int MIDI_AllNotesOff(void);
@@ -22,6 +22,7 @@
 #include "ns_lpt.h"
 #include "ns_sbdm.h"
 #include "ns_adbfx.h"
+#include "ns_disk.h"
 #include "options.h"
 #include "fastmath.h"
 
@@ -88,6 +89,169 @@ unsigned long FixedPointBufferSize22050 = 0;
 
 unsigned long MV_MixPosition;
 
+// Accumulating mixer: every voice is summed into MV_MixAccum at
+// the output scale and the total is clipped into the DMA page once.
+int MV_Accumulate = FALSE;
+
+static int MV_MixAccum[MixBufferSize * 2];
+static int MV_AccumStep = 1;
+static int MV_AccumRightOffset = 0;
+
+/*---------------------------------------------------------------------
+   Function: MV_Accum8BitMono
+
+   Adds an 8 bit voice to the mono accumulator.
+---------------------------------------------------------------------*/
+
+static void MV_Accum8BitMono(
+    unsigned long position,
+    unsigned long rate,
+    unsigned char *start,
+    unsigned long length)
+
+{
+    int *dest;
+    short *volume;
+
+    dest = (int *)MV_MixDestination;
+    volume = MV_LeftVolume;
+
+    if (rate == 0x10000)
+    {
+        // Already at the output rate
+        start += position >> 16;
+        position += length << 16;
+
+        while (length > 0)
+        {
+            *dest++ += volume[*start++];
+            length--;
+        }
+    }
+
+    while (length > 0)
+    {
+        *dest++ += volume[start[position >> 16]];
+        position += rate;
+        length--;
+    }
+
+    MV_MixDestination = (char *)dest;
+    MV_MixPosition = position;
+}
+
+/*---------------------------------------------------------------------
+   Function: MV_Accum8BitStereo
+
+   Adds an 8 bit voice to the stereo accumulator, interleaved or
+   split in two halves for the Ultrasound.
+---------------------------------------------------------------------*/
+
+static void MV_Accum8BitStereo(
+    unsigned long position,
+    unsigned long rate,
+    unsigned char *start,
+    unsigned long length)
+
+{
+    int *dest;
+    short *left;
+    short *right;
+    int sample;
+
+    dest = (int *)MV_MixDestination;
+    left = MV_LeftVolume;
+    right = MV_RightVolume;
+
+    while (length > 0)
+    {
+        sample = start[position >> 16];
+        dest[0] += left[sample];
+        dest[MV_AccumRightOffset] += right[sample];
+        dest += MV_AccumStep;
+        position += rate;
+        length--;
+    }
+
+    MV_MixDestination = (char *)dest;
+    MV_MixPosition = position;
+}
+
+/*---------------------------------------------------------------------
+   Function: MV_WriteAccum
+
+   Clips the accumulator into the specified mix buffer.
+---------------------------------------------------------------------*/
+
+static void MV_WriteAccum(
+    int buffer)
+
+{
+    int *accum;
+    int *end;
+    int *split;
+    unsigned char *dest8;
+    short *dest16;
+    int sample;
+
+    accum = MV_MixAccum;
+    end = MV_MixAccum + MixBufferSize * MV_Channels;
+
+    // The Ultrasound plays the right half from its own buffer
+    split = NULL;
+    if ((MV_SoundCard == UltraSound) && (MV_Channels == 2))
+    {
+        split = MV_MixAccum + MixBufferSize;
+    }
+
+    if (MV_Bits == 8)
+    {
+        dest8 = (unsigned char *)MV_MixBuffer[buffer];
+
+        while (accum < end)
+        {
+            sample = *accum++ + 0x80;
+            if (sample < 0)
+            {
+                sample = 0;
+            }
+            else if (sample > 0xff)
+            {
+                sample = 0xff;
+            }
+            *dest8++ = sample;
+
+            if (accum == split)
+            {
+                dest8 = (unsigned char *)MV_MixBuffer[buffer] + MV_RightChannelOffset;
+            }
+        }
+    }
+    else
+    {
+        dest16 = (short *)MV_MixBuffer[buffer];
+
+        while (accum < end)
+        {
+            sample = *accum++;
+            if (sample < -0x8000)
+            {
+                sample = -0x8000;
+            }
+            else if (sample > 0x7fff)
+            {
+                sample = 0x7fff;
+            }
+            *dest16++ = sample;
+
+            if (accum == split)
+            {
+                dest16 = (short *)(MV_MixBuffer[buffer] + MV_RightChannelOffset);
+            }
+        }
+    }
+}
+
 /*---------------------------------------------------------------------
    Function: MV_Mix
 
@@ -118,7 +282,11 @@ static void MV_Mix(
     MV_LeftVolume = voice->LeftVolume;
     MV_RightVolume = voice->RightVolume;
 
-    if ((MV_Channels == 2) && (IS_QUIET(MV_LeftVolume)))
+    if (MV_Accumulate)
+    {
+        MV_MixDestination = (char *)MV_MixAccum;
+    }
+    else if ((MV_Channels == 2) && (IS_QUIET(MV_LeftVolume)))
     {
         MV_LeftVolume = MV_RightVolume;
         MV_MixDestination += MV_RightChannelOffset;
@@ -158,7 +326,8 @@ static void MV_Mix(
 
         voice->mix(position, rate, start, voclength);
 
-        if (voclength & 1)
+        // The asm mixers work on sample pairs
+        if ((voclength & 1) && !MV_Accumulate)
         {
             MV_MixPosition += rate;
             voclength -= 1;
@@ -274,6 +443,11 @@ void MV_ServiceVoc(
         MV_BufferEmpty[MV_MixPage] = TRUE;
     }
 
+    if (MV_Accumulate && (VoiceList.next != &VoiceList))
+    {
+        memset(MV_MixAccum, 0, MixBufferSize * MV_Channels * sizeof(int));
+    }
+
     // Play any waiting voices
     for (voice = VoiceList.next; voice != &VoiceList; voice = next)
     {
@@ -289,6 +463,11 @@ void MV_ServiceVoc(
             MV_StopVoice(voice);
         }
     }
+
+    if (MV_Accumulate && !MV_BufferEmpty[MV_MixPage])
+    {
+        MV_WriteAccum(MV_MixPage);
+    }
 }
 
 int leftpage = -1;
@@ -558,9 +737,33 @@ void MV_SetVoicePitch(VoiceNode *voice, unsigned long rate)
         voice->RateScale = RateScale22050;
         voice->FixedPointBufferSize = FixedPointBufferSize22050;
         break;
+    default:
+        // Resampled sounds step one sample at a time
+        if (rate == MV_MixRate)
+        {
+            voice->RateScale = 0x10000;
+            voice->FixedPointBufferSize = (0x10000 * MixBufferSize) - 0x10000;
+        }
+        break;
     }
 }
 
+/*---------------------------------------------------------------------
+   Function: MV_GetMixRate
+
+   Returns the rate the voices are mixed at.
+---------------------------------------------------------------------*/
+
+int MV_GetMixRate(void)
+{
+    if (!MV_Installed)
+    {
+        return (0);
+    }
+
+    return (MV_MixRate);
+}
+
 /*---------------------------------------------------------------------
    Function: MV_GetVolumeTable
 
@@ -609,6 +812,13 @@ static void MV_SetVoiceMixMode(
         test |= T_ULTRASOUND;
     }
 
+    if (MV_Accumulate)
+    {
+        voice->mix = (MV_Channels == 1) ? MV_Accum8BitMono : MV_Accum8BitStereo;
+        RestoreInterrupts(flags);
+        return;
+    }
+
     switch (test)
     {
     case T_8BITS | T_MONO:
@@ -715,6 +925,11 @@ int MV_SetMixMode(
 
     case CMS:
         MV_MixMode = STEREO_8BIT;
+        break;
+
+    case DiskWriter:
+        MV_MixMode = mode & STEREO;
+        break;
     }
 
     MV_Channels = 1;
@@ -749,12 +964,18 @@ int MV_SetMixMode(
 
     MV_RightChannelOffset = MV_SampleSize / 2;
 
+    MV_AccumStep = MV_Channels;
+    MV_AccumRightOffset = 1;
+
     if ((MV_SoundCard == UltraSound) && (MV_Channels == 2))
     {
         MV_SampleSize /= 2;
         MV_BufferSize /= 2;
         MV_RightChannelOffset = MV_BufferSize * MV_NumberOfBuffers;
         MV_BufferLength /= 2;
+
+        MV_AccumStep = 1;
+        MV_AccumRightOffset = MixBufferSize;
     }
 
     return (MV_Ok);
@@ -903,6 +1124,13 @@ int MV_StartPlayback(
         MV_MixRate = ADBFX_SampleRate;
         MV_DMAChannel = -1;
         break;
+    case DiskWriter:
+        DISK_BeginBufferedPlayback(MV_MixBuffer[0],
+                                   TotalBufferSize, MV_NumberOfBuffers,
+                                   MV_MixMode, MV_ServiceVoc);
+        MV_MixRate = DISK_SampleRate;
+        MV_DMAChannel = -1;
+        break;
     }
 
     RateScale11025 = (11025 * 0x10000) / MV_MixRate;
@@ -971,6 +1199,9 @@ void MV_StopPlayback(
     case AdlibFX:
         ADBFX_StopPlayback;
         break;
+    case DiskWriter:
+        DISK_StopPlayback();
+        break;
     }
 
     // Make sure all callbacks are done.
@@ -1048,6 +1279,7 @@ void MV_CreateVolumeTable(
     int i;
 
     level = (volume * MaxVolume) / MV_MaxTotalVolume;
+
     if (MV_Bits == 16)
     {
         for (i = 0; i < 65536; i += 256)
@@ -1292,6 +1524,10 @@ int MV_Init(
         status = ADBFX_Init(soundcard);
         break;
 
+    case DiskWriter:
+        status = DISK_Init(soundcard);
+        break;
+
     default:
         break;
 
@@ -1417,6 +1653,9 @@ int MV_Shutdown(
     case AdlibFX:
         ADBFX_Shutdown();
         break;
+    case DiskWriter:
+        DISK_Shutdown();
+        break;
     }
 
     RestoreInterrupts(flags);
@@ -4,6 +4,7 @@
 #define MV_MinVoiceHandle 1
 
 extern int MV_RightChannelOffset;
+extern int MV_Accumulate;
 
 enum MV_Errors
 {
@@ -34,6 +35,7 @@ int MV_VoicePlaying(int handle);
 int MV_KillAllVoices(void);
 int MV_Kill(int handle);
 int MV_SetMixMode(int numchannels, int samplebits);
+int MV_GetMixRate(void);
 int MV_StartPlayback(void);
 void MV_StopPlayback(void);
 int MV_PlayRaw(unsigned char *ptr, unsigned long length,
@@ -57,6 +57,7 @@ int MUSIC_Init(int SoundCard, int Address)
     case SoundMan16:
     case OPL2LPT:
     case OPL3LPT:
+    case DiskWriter:
         status = MUSIC_InitFM(SoundCard, &MUSIC_MidiFunctions, Address);
         break;
 
@@ -116,6 +117,7 @@ int MUSIC_Shutdown(
     case Adlib:
     case OPL2LPT:
     case OPL3LPT:
+    case DiskWriter:
         AL_Shutdown();
         break;
 
@@ -235,6 +237,7 @@ int MUSIC_PlaySong(
     case Adlib:
     case OPL2LPT:
     case OPL3LPT:
+    case DiskWriter:
     case ProAudioSpectrum:
     case SoundMan16:
     case GenMidi:
@@ -283,6 +286,8 @@ int MUSIC_InitAWE32(
     Funcs->PitchBend = AWE32_PitchBend;
     Funcs->SetVolume = NULL;
     Funcs->GetVolume = NULL;
+    Funcs->StartBatch = NULL;
+    Funcs->FlushBatch = NULL;
 
     if (BLASTER_CardHasMixer())
     {
@@ -304,7 +309,7 @@ int MUSIC_InitFM(int card, midifuncs *Funcs, int Address)
 
     status = MIDI_Ok;
 
-    if (card != OPL2LPT && card != OPL3LPT)
+    if (card != OPL2LPT && card != OPL3LPT && card != DiskWriter)
     {
         if (!AL_DetectFM())
         {
@@ -324,6 +329,8 @@ int MUSIC_InitFM(int card, midifuncs *Funcs, int Address)
     Funcs->PitchBend = AL_SetPitchBend;
     Funcs->SetVolume = NULL;
     Funcs->GetVolume = NULL;
+    Funcs->StartBatch = AL_StartBatch;
+    Funcs->FlushBatch = AL_FlushBatch;
 
     switch (card)
     {
@@ -344,6 +351,7 @@ int MUSIC_InitFM(int card, midifuncs *Funcs, int Address)
     case Adlib:
     case OPL2LPT:
     case OPL3LPT:
+    case DiskWriter:
         Funcs->SetVolume = NULL;
         Funcs->GetVolume = NULL;
         break;
@@ -408,6 +416,8 @@ int MUSIC_InitMidi(
     Funcs->PitchBend = MPU_PitchBend;
     Funcs->SetVolume = NULL;
     Funcs->GetVolume = NULL;
+    Funcs->StartBatch = NULL;
+    Funcs->FlushBatch = NULL;
 
     if (card == WaveBlaster)
     {
@@ -446,6 +456,8 @@ int MUSIC_InitGUS(
     Funcs->PitchBend = GUSMIDI_PitchBend;
     Funcs->SetVolume = GUSMIDI_SetVolume;
     Funcs->GetVolume = GUSMIDI_GetVolume;
+    Funcs->StartBatch = NULL;
+    Funcs->FlushBatch = NULL;
 
     MIDI_SetMidiFuncs(Funcs);
 
@@ -475,6 +487,8 @@ int MUSIC_InitCMS(
     Funcs->PitchBend = CMS_PitchBend;
     Funcs->SetVolume = NULL;
     Funcs->GetVolume = NULL;
+    Funcs->StartBatch = NULL;
+    Funcs->FlushBatch = NULL;
 
     MIDI_SetMidiFuncs(Funcs);
 
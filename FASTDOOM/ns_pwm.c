@@ -25,8 +25,6 @@ static int PCSpeaker_PWM_CurrentLength = 0;
 static char *PCSpeaker_PWM_SoundPtr;
 volatile int PCSpeaker_PWM_SoundPlaying;
 
-static task *PCSpeaker_PWM_Timer;
-
 void (*PCSpeaker_PWM_CallBack)(void);
 
 /*---------------------------------------------------------------------
@@ -36,7 +34,7 @@ void (*PCSpeaker_PWM_CallBack)(void);
    transfer.  Calls the user supplied callback function.
 ---------------------------------------------------------------------*/
 
-static void PCSpeaker_PWM_ServiceInterrupt(task *Task)
+static void PCSpeaker_PWM_ServiceInterrupt(void)
 {
     unsigned char value = (unsigned char) *PCSpeaker_PWM_SoundPtr;
 
@@ -79,7 +77,7 @@ void PCSpeaker_PWM_StopPlayback(void)
 {
     if (PCSpeaker_PWM_SoundPlaying)
     {
-        TS_Terminate(PCSpeaker_PWM_Timer);
+        TS_SetSampleService(NULL, 0);
         PCSpeaker_PWM_SoundPlaying = 0;
         PCSpeaker_PWM_BufferStart = NULL;
     }
@@ -118,8 +116,7 @@ int PCSpeaker_PWM_BeginBufferedPlayback(
 
     PCSpeaker_PWM_SoundPlaying = 1;
 
-    PCSpeaker_PWM_Timer = TS_ScheduleTask(PCSpeaker_PWM_ServiceInterrupt, PCSpeaker_PWM_SampleRate, 1, NULL);
-    TS_Dispatch();
+    TS_SetSampleService(PCSpeaker_PWM_ServiceInterrupt, PCSpeaker_PWM_SampleRate);
 
     return (PCSpeaker_PWM_Ok);
 }
@@ -26,8 +26,6 @@ static int SBDM_CurrentLength = 0;
 static char *SBDM_SoundPtr;
 volatile int SBDM_SoundPlaying;
 
-static task *SBDM_Timer;
-
 void (*SBDM_CallBack)(void);
 
 /*---------------------------------------------------------------------
@@ -37,7 +35,7 @@ void (*SBDM_CallBack)(void);
    transfer.  Calls the user supplied callback function.
 ---------------------------------------------------------------------*/
 
-static void SBDM_ServiceInterrupt(task *Task)
+static void SBDM_ServiceInterrupt(void)
 {
     BLASTER_WriteDSP(DSP_DirectDAC);
     BLASTER_WriteDSP(*SBDM_SoundPtr);
@@ -77,7 +75,7 @@ void SBDM_StopPlayback(void)
 {
     if (SBDM_SoundPlaying)
     {
-        TS_Terminate(SBDM_Timer);
+        TS_SetSampleService(NULL, 0);
         SBDM_SoundPlaying = 0;
         SBDM_BufferStart = NULL;
     }
@@ -113,8 +111,7 @@ int SBDM_BeginBufferedPlayback(
 
     SBDM_SoundPlaying = 1;
 
-    SBDM_Timer = TS_ScheduleTask(SBDM_ServiceInterrupt, SBDM_SampleRate, 1, NULL);
-    TS_Dispatch();
+    TS_SetSampleService(SBDM_ServiceInterrupt, SBDM_SampleRate);
 
     return (SBDM_Ok);
 }
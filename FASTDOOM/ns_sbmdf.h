@@ -19,6 +19,10 @@
 #define NUM_VOICES 9
 #define NUM_CHANNELS 16
 
+/* Two banks of registers on an OPL3 */
+#define AL_NumRegisters 0x200
+#define AL_QueueSize 256
+
 #define NOTE_ON 0x2000 /* Used to turn note on or toggle note */
 #define NOTE_OFF 0x0000
 
@@ -1,8 +1,10 @@
 #include <conio.h>
 #include <dos.h>
 #include <stddef.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include "ns_inter.h"
+#include "ns_task.h"
 #include "ns_cards.h"
 #include "ns_sb.h"
 #include "ns_user.h"
@@ -121,6 +123,35 @@ static int AL_MaxMidiChannel = 16;
 static int AL_OPL2LPT = FALSE;
 static int AL_OPL3LPT = FALSE;
 
+// Register writes of the file device, one line per write with the
+// virtual clock, the register (0x100 up for the second bank) and
+// the value.
+
+static FILE *AL_DiskLog = NULL;
+
+// Last value written to every register of the left and right
+// chips, -1 when unknown. Registers below 0x20 (test, timers,
+// mode) are never shadowed.
+
+static short AL_Shadow[2][AL_NumRegisters];
+
+// Writes made while the MIDI service routine runs are queued and
+// sent in order when it finishes.
+
+typedef struct
+{
+   short port;
+   short reg;
+   unsigned char data;
+} ALWRITE;
+
+static ALWRITE AL_Queue[AL_QueueSize];
+static int AL_QueueCount = 0;
+static int AL_Batching = FALSE;
+
+unsigned long AL_WritesIssued = 0;
+unsigned long AL_WritesSuppressed = 0;
+
 void AL_SendOutputToPort_OPL2LPT(int port, int reg, int data)
 {
    int i;
@@ -200,15 +231,26 @@ void AL_SendOutputToPort_OPL3LPT(int port, int reg, int data)
 
 
 /*---------------------------------------------------------------------
-   Function: AL_SendOutputToPort
+   Function: AL_WriteRegister
 
-   Sends data to the Adlib using a specified port.
+   Writes a register on the Adlib using a specified port.
 ---------------------------------------------------------------------*/
 
-void AL_SendOutputToPort(int port, int reg, int data)
+static void AL_WriteRegister(int port, int reg, int data)
 {
    int delay;
 
+   if (AL_DiskLog)
+   {
+      if (port == AL_RightPort && port != AL_LeftPort)
+      {
+         reg |= 0x100;
+      }
+
+      fprintf(AL_DiskLog, "%lu %03X %02X\n", TS_VirtualTime, reg, data);
+      return;
+   }
+
    if (AL_OPL2LPT)
    {
       AL_SendOutputToPort_OPL2LPT(port, reg, data);
@@ -239,6 +281,129 @@ void AL_SendOutputToPort(int port, int reg, int data)
    }
 }
 
+/*---------------------------------------------------------------------
+   Function: AL_ClearShadow
+
+   Forgets the register values of both chips.
+---------------------------------------------------------------------*/
+
+static void AL_ClearShadow(void)
+{
+   int reg;
+
+   for (reg = 0; reg < AL_NumRegisters; reg++)
+   {
+      AL_Shadow[0][reg] = -1;
+      AL_Shadow[1][reg] = -1;
+   }
+}
+
+/*---------------------------------------------------------------------
+   Function: AL_SendQueue
+
+   Writes the queued registers in the order they were sent.
+---------------------------------------------------------------------*/
+
+static void AL_SendQueue(void)
+{
+   ALWRITE *write;
+   ALWRITE *end;
+
+   end = AL_Queue + AL_QueueCount;
+   for (write = AL_Queue; write < end; write++)
+   {
+      AL_WriteRegister(write->port, write->reg, write->data);
+   }
+
+   AL_QueueCount = 0;
+}
+
+/*---------------------------------------------------------------------
+   Function: AL_StartBatch
+
+   Queues register writes until AL_FlushBatch is called.
+---------------------------------------------------------------------*/
+
+void AL_StartBatch(void)
+{
+   AL_Batching = TRUE;
+}
+
+/*---------------------------------------------------------------------
+   Function: AL_FlushBatch
+
+   Sends the queued register writes and goes back to writing
+   directly.
+---------------------------------------------------------------------*/
+
+void AL_FlushBatch(void)
+{
+   AL_SendQueue();
+   AL_Batching = FALSE;
+}
+
+/*---------------------------------------------------------------------
+   Function: AL_SendOutputToPort
+
+   Sends data to the Adlib using a specified port.  Writes that
+   would not change the register are dropped.
+---------------------------------------------------------------------*/
+
+void AL_SendOutputToPort(int port, int reg, int data)
+{
+   ALWRITE *write;
+   int chip;
+
+   data &= 0xff;
+
+   if ((reg & 0xff) >= 0x20 && reg < AL_NumRegisters)
+   {
+      if (port == AL_LeftPort)
+      {
+         chip = 0;
+      }
+      else if (port == AL_RightPort)
+      {
+         chip = 1;
+      }
+      else
+      {
+         // Port shared by both chips
+         AL_Shadow[0][reg] = -1;
+         AL_Shadow[1][reg] = -1;
+         chip = -1;
+      }
+
+      if (chip >= 0)
+      {
+         if (AL_Shadow[chip][reg] == data)
+         {
+            AL_WritesSuppressed++;
+            return;
+         }
+
+         AL_Shadow[chip][reg] = data;
+      }
+   }
+
+   AL_WritesIssued++;
+
+   if (!AL_Batching)
+   {
+      AL_WriteRegister(port, reg, data);
+      return;
+   }
+
+   if (AL_QueueCount == AL_QueueSize)
+   {
+      AL_SendQueue();
+   }
+
+   write = &AL_Queue[AL_QueueCount++];
+   write->port = port;
+   write->reg = reg;
+   write->data = data;
+}
 
 /*---------------------------------------------------------------------
    Function: AL_SendOutput
@@ -1193,11 +1358,24 @@ void AL_Shutdown(
     void)
 
 {
+   // Counted before the reset writes below
+   if (TS_Stats || AL_DiskLog)
+   {
+      printf("AL_Shutdown: %lu OPL writes issued, %lu suppressed by the shadow registers\n",
+             AL_WritesIssued, AL_WritesSuppressed);
+   }
+
    AL_StereoOff();
 
    AL_OPL3 = FALSE;
    AL_ResetVoices();
    AL_Reset();
+
+   if (AL_DiskLog)
+   {
+      fclose(AL_DiskLog);
+      AL_DiskLog = NULL;
+   }
 }
 
 /*---------------------------------------------------------------------
@@ -1236,6 +1414,13 @@ int AL_Init(int soundcard, int Address)
       AL_OPL3LPT = TRUE;
       ADLIB_PORT = Address;
       break;
+   case DiskWriter:
+      AL_OPL3 = TRUE;
+      AL_Stereo = TRUE;
+      AL_LeftPort = 0x388;
+      AL_RightPort = 0x38A;
+      AL_DiskLog = fopen("oplwrite.log", "w");
+      break;
    case ProAudioSpectrum:
    case SoundMan16:
       AL_OPL3 = TRUE;
@@ -1279,6 +1464,7 @@ int AL_Init(int soundcard, int Address)
       break;
    }
 
+   AL_ClearShadow();
    AL_CalcPitchInfo();
    AL_Reset();
    AL_ResetVoices();
@@ -15,10 +15,15 @@ enum AL_Errors
 
 static int ADLIB_PORT;
 
+extern unsigned long AL_WritesIssued;
+extern unsigned long AL_WritesSuppressed;
+
 void AL_SendOutputToPort(int port, int reg, int data);
 void AL_SendOutputToPort_OPL2LPT(int port, int reg, int data);
 void AL_SendOutputToPort_OPL3LPT(int port, int reg, int data);
 void AL_SendOutput(int voice, int reg, int data);
+void AL_StartBatch(void);
+void AL_FlushBatch(void);
 void AL_StereoOn(void);
 void AL_StereoOff(void);
 void AL_Shutdown(void);
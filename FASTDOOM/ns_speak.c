@@ -24,8 +24,6 @@ static int PCSpeaker_CurrentLength = 0;
 static char *PCSpeaker_SoundPtr;
 volatile int PCSpeaker_SoundPlaying;
 
-static task *PCSpeaker_Timer;
-
 void (*PCSpeaker_CallBack)(void);
 
 /*---------------------------------------------------------------------
@@ -35,7 +33,7 @@ void (*PCSpeaker_CallBack)(void);
    transfer.  Calls the user supplied callback function.
 ---------------------------------------------------------------------*/
 
-static void PCSpeaker_ServiceInterrupt(task *Task)
+static void PCSpeaker_ServiceInterrupt(void)
 {
     if (*PCSpeaker_SoundPtr > -128)
     {
@@ -89,7 +87,7 @@ void PCSpeaker_StopPlayback(void)
     {
         // Turn off
         outp(0x61, inp(0x61) & 0xFC);
-        TS_Terminate(PCSpeaker_Timer);
+        TS_SetSampleService(NULL, 0);
         PCSpeaker_SoundPlaying = 0;
         PCSpeaker_BufferStart = NULL;
     }
@@ -125,8 +123,7 @@ int PCSpeaker_BeginBufferedPlayback(
 
     PCSpeaker_SoundPlaying = 1;
 
-    PCSpeaker_Timer = TS_ScheduleTask(PCSpeaker_ServiceInterrupt, PCSpeaker_SampleRate, 1, NULL);
-    TS_Dispatch();
+    TS_SetSampleService(PCSpeaker_ServiceInterrupt, PCSpeaker_SampleRate);
 
     return (PCSpeaker_Ok);
 }
@@ -51,33 +51,62 @@ static unsigned long oldStackPointer;
 
 #endif
 
+// Shortest timer period (1.7 ms). Nearby deadlines share an interrupt,
+// and a period outlasts the slowest task, so no interrupt is lost.
+#define MinServiceRate 0x800L
+
 static task HeadTask;
 static task *TaskList = &HeadTask;
 
 static void(__interrupt __far *OldInt8)(void);
 
+// The timer runs in mode 2 and is reloaded for each task deadline.
+// TaskServiceRate is the period now running, which started at
+// TaskServiceClock, and NextServiceRate the count loaded after it.
 static volatile long TaskServiceRate = 0x10000L;
+static volatile long NextServiceRate = 0x10000L;
 static volatile long TaskServiceCount = 0;
+static volatile unsigned long TaskServiceClock = 0;
+static unsigned long LastClock = 0;
 
-#ifndef NOINTS
-static volatile int TS_TimesInInterrupt;
-#endif
+// A sample output routine runs on every timer interrupt, ahead of and
+// apart from the task list, and holds the timer at its own rate.
+static void (*SampleService)(void) = NULL;
+static long SampleServiceRate = 0x10000L;
+static unsigned long SampleServiceStart;
+static unsigned long SampleServiceCalls;
+static unsigned long SampleServiceClocks;
+
+static task *CurrentTask = NULL;
 
 static char TS_Installed = FALSE;
 
 volatile int TS_InInterrupt = FALSE;
 
+int TS_VirtualClock = FALSE;
+unsigned long TS_VirtualTime = 0;
+
+int TS_Stats = FALSE;
+taskstats TS_StatsTable[TS_MaxStats];
+int TS_NumStats = 0;
+
 /*---------------------------------------------------------------------
    Function prototypes
 ---------------------------------------------------------------------*/
 
 static void TS_FreeTaskList(void);
 static void TS_SetClockSpeed(long speed);
-static long TS_SetTimer(long TickBase);
-static void TS_SetTimerToMaxTaskRate(void);
+static int TS_SyncClock(void);
+static long TS_ReadCounter(void);
+static void TS_RecordStats(void *service, long rate, unsigned long calls,
+                           unsigned long clocks, unsigned long start);
+static void TS_InsertTask(task *node);
+static long TS_NextPeriod(unsigned long start);
+static void TS_ProgramTimer(void);
+static void TS_LoadNextPeriod(void);
+static void TS_ServiceTasks(void);
 static void __interrupt __far TS_ServiceSchedule(void);
 static void __interrupt __far TS_ServiceScheduleIntEnabled(void);
-static void TS_AddTask(task *ptr);
 static int TS_Startup(void);
 static void RestoreRealTimeClock(void);
 
@@ -111,6 +140,7 @@ static void TS_FreeTaskList(void)
     while (node != TaskList)
     {
         next = node->next;
+        TS_RecordStats((void *)node->TaskService, node->rate, node->calls, node->clocks, node->start);
         FreeMem(node);
         node = next;
     }
@@ -136,62 +166,338 @@ static void TS_SetClockSpeed(long speed)
         TaskServiceRate = 0x10000L;
     }
 
-    outp(0x43, 0x36);
+    NextServiceRate = TaskServiceRate;
+
+    outp(0x43, 0x34);
     outp(0x40, TaskServiceRate);
     outp(0x40, TaskServiceRate >> 8);
 
     RestoreInterrupts(flags);
 }
 
-static long TS_SetTimer(long TickBase)
+/*---------------------------------------------------------------------
+   Function: TS_SyncClock
+
+   Moves TaskServiceClock up to now before the timer is restarted.
+   Returns TRUE if the interrupt for the period that ended is still
+   pending. That period has then been counted here already.
+---------------------------------------------------------------------*/
+
+static int TS_SyncClock(void)
 {
-    long speed;
+    int pending;
+    long elapsed;
 
-    // VITI95: OPTIMIZE
-    speed = 1192030L / TickBase;
-    if (speed < TaskServiceRate)
+    outp(0x20, 0x0A);
+    pending = inp(0x20) & 0x01;
+
+    if (pending)
+    {
+        // The counter is already in the period loaded after it
+        TaskServiceClock += TaskServiceRate;
+        TaskServiceCount += TaskServiceRate;
+        elapsed = NextServiceRate - TS_ReadCounter();
+    }
+    else
+    {
+        elapsed = TaskServiceRate - TS_ReadCounter();
+    }
+
+    TaskServiceClock += elapsed;
+    TaskServiceCount += elapsed;
+
+    return (pending);
+}
+
+static long TS_ReadCounter(void)
+{
+    long count;
+
+    // Latch counter 0
+    outp(0x43, 0x00);
+    count = inp(0x40);
+    count |= inp(0x40) << 8;
+
+    if (count == 0)
+    {
+        count = 0x10000L;
+    }
+
+    return (count);
+}
+
+static void TS_RecordStats(void *service, long rate, unsigned long calls,
+                           unsigned long clocks, unsigned long start)
+{
+    taskstats *stats;
+    int i;
+
+    if (!TS_Stats || calls == 0)
+    {
+        return;
+    }
+
+    // Every song starts a new task, so tasks are summed per service
+    for (i = 0; i < TS_NumStats; i++)
+    {
+        if (TS_StatsTable[i].service == service)
+        {
+            break;
+        }
+    }
+
+    stats = &TS_StatsTable[i];
+
+    if (i == TS_NumStats)
     {
-        TS_SetClockSpeed(speed);
+        if (TS_NumStats >= TS_MaxStats)
+        {
+            return;
+        }
+
+        TS_NumStats++;
+        stats->service = service;
+        stats->calls = 0;
+        stats->clocks = 0;
+        stats->lifetime = 0;
     }
 
-    return (speed);
+    stats->rate = 1192030L / rate;
+    stats->calls += calls;
+    stats->clocks += clocks;
+    stats->lifetime += TaskServiceClock - start;
 }
 
-static void TS_SetTimerToMaxTaskRate(void)
+/*---------------------------------------------------------------------
+   Function: TS_InsertTask
+
+   Links a task into the list. Running tasks are kept in order of
+   due time, ahead of the inactive and offline ones.
+---------------------------------------------------------------------*/
+
+static void TS_InsertTask(
+    task *node)
+
 {
     task *ptr;
-    long MaxServiceRate;
-    unsigned flags;
 
-    flags = DisableInterrupts();
+    ptr = TaskList;
+    if (node->active && !node->offline)
+    {
+        ptr = TaskList->next;
+        while (ptr != TaskList && ptr->active && !ptr->offline &&
+               (long)(node->due - ptr->due) >= 0)
+        {
+            ptr = ptr->next;
+        }
+    }
+
+    LL_AddNode(ptr, node, next, prev);
+}
+
+/*---------------------------------------------------------------------
+   Function: TS_NextPeriod
+
+   Returns the timer period from start to the first deadline after it.
+   Tasks due by start are serviced when that period begins.
+---------------------------------------------------------------------*/
 
-    MaxServiceRate = 0x10000L;
+static long TS_NextPeriod(
+    unsigned long start)
+
+{
+    task *ptr;
+    unsigned long due;
+    long period;
+
+    period = 0x10000L;
 
     ptr = TaskList->next;
-    while (ptr != TaskList)
+    while (ptr != TaskList && ptr->active && !ptr->offline)
     {
-        if (ptr->rate < MaxServiceRate)
+        due = ptr->due;
+        while ((long)(due - start) <= 0)
+        {
+            due += ptr->rate;
+        }
+
+        if ((long)(due - start) < period)
+        {
+            period = due - start;
+        }
+
+        // The tasks after this one are due later still
+        if (due == ptr->due)
         {
-            MaxServiceRate = ptr->rate;
+            break;
         }
 
         ptr = ptr->next;
     }
 
-    if (TaskServiceRate != MaxServiceRate)
+    if (period < MinServiceRate)
+    {
+        period = MinServiceRate;
+    }
+
+    return (period);
+}
+
+/*---------------------------------------------------------------------
+   Function: TS_ProgramTimer
+
+   Restarts the timer at the sample output rate, or else for the first
+   task deadline. The interrupt keeps it up to date from then on.
+---------------------------------------------------------------------*/
+
+static void TS_ProgramTimer(void)
+{
+    unsigned flags;
+    int pending;
+
+    if (TS_InInterrupt)
+    {
+        return;
+    }
+
+    flags = DisableInterrupts();
+
+    if (SampleService != NULL && TaskServiceRate == SampleServiceRate &&
+        NextServiceRate == SampleServiceRate)
+    {
+        RestoreInterrupts(flags);
+        return;
+    }
+
+    pending = TS_SyncClock();
+
+    if (SampleService != NULL)
+    {
+        TS_SetClockSpeed(SampleServiceRate);
+    }
+    else
+    {
+        TS_SetClockSpeed(TS_NextPeriod(TaskServiceClock));
+    }
+
+    // The pending interrupt must not count its period again
+    if (pending)
     {
-        TS_SetClockSpeed(MaxServiceRate);
+        TaskServiceRate = 0;
     }
 
     RestoreInterrupts(flags);
 }
 
+/*---------------------------------------------------------------------
+   Function: TS_LoadNextPeriod
+
+   Loads the count for the period after the one now running. It is
+   called first thing in the interrupt, so the count is in place
+   before the running period can end, however long the tasks take.
+   The tasks about to run are stepped past by TS_NextPeriod. With a
+   sample service the timer is moved to its rate here too, in case
+   TS_ProgramTimer was called from inside the interrupt.
+---------------------------------------------------------------------*/
+
+static void TS_LoadNextPeriod(void)
+{
+    if (SampleService != NULL)
+    {
+        NextServiceRate = SampleServiceRate;
+    }
+    else
+    {
+        NextServiceRate = TS_NextPeriod(TaskServiceClock + TaskServiceRate);
+    }
+
+    if (NextServiceRate != TaskServiceRate)
+    {
+        outp(0x40, NextServiceRate);
+        outp(0x40, NextServiceRate >> 8);
+    }
+}
+
+/*---------------------------------------------------------------------
+   Function: TS_ServiceTasks
+
+   Outputs the next sample and runs the tasks that have come due,
+   earliest first. A task is put back in order before it runs, so it
+   may reschedule or terminate itself.
+---------------------------------------------------------------------*/
+
+static void TS_ServiceTasks(void)
+{
+    task *ptr;
+    long before;
+    long after;
+
+    if (SampleService != NULL)
+    {
+        if (TS_Stats)
+        {
+            before = TS_ReadCounter();
+            SampleService();
+            after = TS_ReadCounter();
+
+            if (after > before)
+            {
+                before += TaskServiceRate;
+            }
+
+            SampleServiceCalls++;
+            SampleServiceClocks += before - after;
+        }
+        else
+        {
+            SampleService();
+        }
+    }
+
+    ptr = TaskList->next;
+    while (ptr != TaskList && ptr->active && !ptr->offline &&
+           (long)(TaskServiceClock - ptr->due) >= 0)
+    {
+        LL_RemoveNode(ptr, next, prev);
+        ptr->due += ptr->rate;
+        TS_InsertTask(ptr);
+
+        if (TS_Stats)
+        {
+            CurrentTask = ptr;
+
+            before = TS_ReadCounter();
+            ptr->TaskService(ptr);
+            after = TS_ReadCounter();
+
+            if (after > before)
+            {
+                before += TaskServiceRate;
+            }
+
+            // Unless it terminated itself
+            if (CurrentTask != NULL)
+            {
+                ptr->calls++;
+                ptr->clocks += before - after;
+            }
+
+            CurrentTask = NULL;
+        }
+        else
+        {
+            ptr->TaskService(ptr);
+        }
+
+        ptr = TaskList->next;
+    }
+}
+
 #ifdef NOINTS
 
 static void __interrupt __far TS_ServiceSchedule(void)
 {
-    task *ptr;
-    task *next;
+    long elapsed;
 
     TS_InInterrupt = TRUE;
 
@@ -203,34 +509,26 @@ static void __interrupt __far TS_ServiceSchedule(void)
     SetStack(StackSelector, StackPointer);
 #endif
 
-    ptr = TaskList->next;
-    while (ptr != TaskList)
-    {
-        next = ptr->next;
+    // The period that just ended, then the one loaded after it
+    elapsed = TaskServiceRate;
+    TaskServiceClock += elapsed;
+    TaskServiceRate = NextServiceRate;
+    TS_LoadNextPeriod();
 
-        if (ptr->active)
-        {
-            ptr->count += TaskServiceRate;
-            //JIM
-            //         if ( ptr->count >= ptr->rate )
-            while (ptr->count >= ptr->rate)
-            {
-                ptr->count -= ptr->rate;
-                ptr->TaskService(ptr);
-            }
-        }
-        ptr = next;
-    }
+    TS_ServiceTasks();
 
 #ifdef USESTACK
     // restore stack
     SetStack(oldStackSelector, oldStackPointer);
 #endif
 
-    TaskServiceCount += TaskServiceRate;
+    TaskServiceCount += elapsed;
     if (TaskServiceCount > 0xffffL)
     {
         TaskServiceCount &= 0xffff;
+
+        // _chain_intr doesn't return here
+        TS_InInterrupt = FALSE;
         _chain_intr(OldInt8);
     }
 
@@ -243,11 +541,14 @@ static void __interrupt __far TS_ServiceSchedule(void)
 
 static void __interrupt __far TS_ServiceScheduleIntEnabled(void)
 {
-    task *ptr;
-    task *next;
+    long elapsed;
 
-    TS_TimesInInterrupt++;
-    TaskServiceCount += TaskServiceRate;
+    elapsed = TaskServiceRate;
+    TaskServiceClock += elapsed;
+    TaskServiceRate = NextServiceRate;
+    TS_LoadNextPeriod();
+
+    TaskServiceCount += elapsed;
     if (TaskServiceCount > 0xffffL)
     {
         TaskServiceCount &= 0xffff;
@@ -272,26 +573,7 @@ static void __interrupt __far TS_ServiceScheduleIntEnabled(void)
     SetStack(StackSelector, StackPointer);
 #endif
 
-    while (TS_TimesInInterrupt)
-    {
-        ptr = TaskList->next;
-        while (ptr != TaskList)
-        {
-            next = ptr->next;
-
-            if (ptr->active)
-            {
-                ptr->count += TaskServiceRate;
-                if (ptr->count >= ptr->rate)
-                {
-                    ptr->count -= ptr->rate;
-                    ptr->TaskService(ptr);
-                }
-            }
-            ptr = next;
-        }
-        TS_TimesInInterrupt--;
-    }
+    TS_ServiceTasks();
 
     _disable();
 
@@ -400,12 +682,9 @@ static int TS_Startup(
         TaskList->prev = TaskList;
 
         TaskServiceRate = 0x10000L;
+        NextServiceRate = 0x10000L;
         TaskServiceCount = 0;
 
-#ifndef NOINTS
-        TS_TimesInInterrupt = 0;
-#endif
-
         OldInt8 = _dos_getvect(0x08);
 #ifdef NOINTS
         _dos_setvect(0x08, TS_ServiceSchedule);
@@ -414,11 +693,62 @@ static int TS_Startup(
 #endif
 
         TS_Installed = TRUE;
+
+        // Switch the timer to mode 2 so it can be reloaded on the fly
+        TS_SetClockSpeed(0);
     }
 
     return (TASK_Ok);
 }
 
+/*---------------------------------------------------------------------
+   Function: TS_GetClock
+
+   Returns the PIT clocks (1193182 Hz) elapsed since the task manager
+   was installed, including the part of the current timer period read
+   back from the 8254.
+---------------------------------------------------------------------*/
+
+unsigned long TS_GetClock(
+    void)
+
+{
+    unsigned flags;
+    unsigned long clock;
+    unsigned long rate;
+    unsigned long count;
+
+    flags = DisableInterrupts();
+
+    clock = TaskServiceClock;
+    rate = TaskServiceRate;
+
+    // A period that ended while interrupts were off is not counted yet
+    outp(0x20, 0x0A);
+    if (inp(0x20) & 0x01)
+    {
+        clock += rate;
+        rate = NextServiceRate;
+    }
+
+    count = TS_ReadCounter();
+
+    RestoreInterrupts(flags);
+
+    // Mode 2 counts down by one from the period length
+    clock += rate - count;
+
+    // Never go backwards if the counter wrapped during the readback
+    if ((long)(clock - LastClock) < 0)
+    {
+        clock = LastClock;
+    }
+
+    LastClock = clock;
+
+    return (clock);
+}
+
 /*---------------------------------------------------------------------
    Function: TS_Shutdown
 
@@ -433,8 +763,20 @@ void TS_Shutdown(
     {
         TS_FreeTaskList();
 
+        if (SampleService != NULL)
+        {
+            TS_RecordStats((void *)SampleService, SampleServiceRate, SampleServiceCalls,
+                           SampleServiceClocks, SampleServiceStart);
+            SampleService = NULL;
+        }
+
         TS_SetClockSpeed(0);
 
+        // Give the BIOS back its square wave
+        outp(0x43, 0x36);
+        outp(0x40, 0);
+        outp(0x40, 0);
+
         _dos_setvect(0x08, OldInt8);
 
 #ifdef USESTACK
@@ -465,6 +807,7 @@ task *TS_ScheduleTask(
 
 {
     task *ptr;
+    unsigned flags;
 
 #ifdef USE_USRHOOKS
     int status;
@@ -490,28 +833,74 @@ task *TS_ScheduleTask(
 
         ptr->TaskService = Function;
         ptr->data = data;
-        ptr->rate = TS_SetTimer(rate);
+        ptr->offline = TS_VirtualClock;
+        // VITI95: OPTIMIZE
+        ptr->rate = 1192030L / rate;
         ptr->count = 0;
+        ptr->due = 0;
+        ptr->start = 0;
+        ptr->calls = 0;
+        ptr->clocks = 0;
         ptr->priority = priority;
         ptr->active = FALSE;
 
-        TS_AddTask(ptr);
+        flags = DisableInterrupts();
+        TS_InsertTask(ptr);
+        RestoreInterrupts(flags);
     }
 
     return (ptr);
 }
 
 /*---------------------------------------------------------------------
-   Function: TS_AddTask
+   Function: TS_SetSampleService
 
-   Adds a new task to our list of tasks.
+   Installs the routine that outputs one sample per timer interrupt
+   at the given rate, or removes it when Function is NULL. It is
+   called directly by the interrupt instead of through the task list.
 ---------------------------------------------------------------------*/
 
-static void TS_AddTask(
-    task *node)
+int TS_SetSampleService(
+    void (*Function)(void),
+    int rate)
 
 {
-    LL_SortedInsertion(TaskList, node, next, prev, task, priority);
+    unsigned flags;
+    int status;
+
+    if (!TS_Installed)
+    {
+        status = TS_Startup();
+        if (status != TASK_Ok)
+        {
+            return (status);
+        }
+    }
+
+    flags = DisableInterrupts();
+
+    if (SampleService != NULL)
+    {
+        TS_RecordStats((void *)SampleService, SampleServiceRate, SampleServiceCalls,
+                       SampleServiceClocks, SampleServiceStart);
+    }
+
+    SampleService = Function;
+    SampleServiceRate = 0x10000L;
+    if (Function != NULL)
+    {
+        SampleServiceRate = 1192030L / rate;
+    }
+
+    SampleServiceStart = TaskServiceClock;
+    SampleServiceCalls = 0;
+    SampleServiceClocks = 0;
+
+    TS_ProgramTimer();
+
+    RestoreInterrupts(flags);
+
+    return (TASK_Ok);
 }
 
 /*---------------------------------------------------------------------
@@ -540,9 +929,17 @@ int TS_Terminate(
             LL_RemoveNode(NodeToRemove, next, prev);
             NodeToRemove->next = NULL;
             NodeToRemove->prev = NULL;
-            FreeMem(NodeToRemove);
 
-            TS_SetTimerToMaxTaskRate();
+            TS_RecordStats((void *)NodeToRemove->TaskService, NodeToRemove->rate,
+                           NodeToRemove->calls, NodeToRemove->clocks,
+                           NodeToRemove->start);
+
+            if (NodeToRemove == CurrentTask)
+            {
+                CurrentTask = NULL;
+            }
+
+            FreeMem(NodeToRemove);
 
             RestoreInterrupts(flags);
 
@@ -568,6 +965,7 @@ void TS_Dispatch(
 
 {
     task *ptr;
+    task *next;
     unsigned flags;
 
     flags = DisableInterrupts();
@@ -575,10 +973,23 @@ void TS_Dispatch(
     ptr = TaskList->next;
     while (ptr != TaskList)
     {
-        ptr->active = TRUE;
-        ptr = ptr->next;
+        next = ptr->next;
+
+        if (!ptr->active)
+        {
+            ptr->active = TRUE;
+            ptr->start = TaskServiceClock;
+            ptr->due = TaskServiceClock + ptr->rate;
+
+            LL_RemoveNode(ptr, next, prev);
+            TS_InsertTask(ptr);
+        }
+
+        ptr = next;
     }
 
+    TS_ProgramTimer();
+
     RestoreInterrupts(flags);
 }
 
@@ -597,8 +1008,50 @@ void TS_SetTaskRate(
 
     flags = DisableInterrupts();
 
-    Task->rate = TS_SetTimer(rate);
-    TS_SetTimerToMaxTaskRate();
+    // VITI95: OPTIMIZE
+    Task->rate = 1192030L / rate;
+    if (!Task->offline)
+    {
+        TS_ProgramTimer();
+    }
 
     RestoreInterrupts(flags);
 }
+
+/*---------------------------------------------------------------------
+   Function: TS_AdvanceClock
+
+   Moves the virtual clock forward and runs the offline tasks that
+   came due, each at its own point in time.
+---------------------------------------------------------------------*/
+
+void TS_AdvanceClock(
+    unsigned long clocks)
+
+{
+    task *ptr;
+    task *next;
+    unsigned long start;
+
+    start = TS_VirtualTime;
+
+    ptr = TaskList->next;
+    while (ptr != TaskList)
+    {
+        next = ptr->next;
+
+        if (ptr->active && ptr->offline)
+        {
+            ptr->count += clocks;
+            while (ptr->count >= ptr->rate)
+            {
+                ptr->count -= ptr->rate;
+                TS_VirtualTime = start + clocks - ptr->count;
+                ptr->TaskService(ptr);
+            }
+        }
+        ptr = next;
+    }
+
+    TS_VirtualTime = start + clocks;
+}
@@ -16,21 +16,59 @@ typedef struct task
    void *data;
    long rate;
    volatile long count;
+   unsigned long due;
+   unsigned long start;
+   unsigned long calls;
+   unsigned long clocks;
    int priority;
    int active;
+   int offline;
 } task;
 
+// With TS_Stats set, the time spent in each task is measured and
+// added to the TS_StatsTable entry of its service function once the
+// task ends. Times are in PIT clocks.
+
+#define TS_MaxStats 16
+
+typedef struct
+{
+   void *service;
+   long rate;
+   unsigned long calls;
+   unsigned long clocks;
+   unsigned long lifetime;
+} taskstats;
+
+extern int TS_Stats;
+extern taskstats TS_StatsTable[TS_MaxStats];
+extern int TS_NumStats;
+
 // TS_InInterrupt is TRUE during a taskman interrupt.
 // Use this if you have code that may be used both outside
 // and within interrupts.
 
 extern volatile int TS_InInterrupt;
 
+// Tasks scheduled while TS_VirtualClock is set are not run by the
+// timer interrupt but by TS_AdvanceClock. TS_VirtualTime is the
+// virtual clock in timer ticks.
+
+extern int TS_VirtualClock;
+extern unsigned long TS_VirtualTime;
+
 void TS_Shutdown(void);
 task *TS_ScheduleTask(void (*Function)(task *), int rate,
                       int priority, void *data);
 int TS_Terminate(task *ptr);
 void TS_Dispatch(void);
 void TS_SetTaskRate(task *Task, int rate);
+int TS_SetSampleService(void (*Function)(void), int rate);
+
+// TS_GetClock counts PIT clocks, 1193182 a second
+#define PITCLOCKSPERMS 1193
+
+unsigned long TS_GetClock(void);
+void TS_AdvanceClock(unsigned long clocks);
 
 #endif
@@ -9,4 +9,8 @@
 #define USE_BACKBUFFER
 #endif
 
+#if defined(MODE_CGA) || defined(MODE_CGA_BW) || defined(MODE_HERC) || defined(MODE_CGA16) || defined(MODE_CGA_AFH) || defined(MODE_EGA16) || defined(MODE_CGA136)
+#define USE_DIRTYROWS
+#endif
+
 #endif
@@ -1174,6 +1174,7 @@ void A_VileChase(mobj_t *actor)
                     corpsehit->flags = info->flags;
                     corpsehit->health = info->spawnhealth;
                     corpsehit->target = NULL;
+                    P_CheckNeedClip(corpsehit);
 
                     return;
                 }
@@ -1389,6 +1390,7 @@ void A_SkullAttack(mobj_t *actor)
 
     dest = actor->target;
     actor->flags |= MF_SKULLFLY;
+    P_CheckNeedClip(actor);
 
     S_StartSound(actor, actor->info->attacksound);
     A_FaceTarget(actor);
@@ -128,9 +128,8 @@ typedef struct
     } d;
 } intercept_t;
 
-#define MAXINTERCEPTS 128
-
-extern intercept_t intercepts[MAXINTERCEPTS];
+// Grows as needed while the intercepts are added
+extern intercept_t *intercepts;
 extern intercept_t *intercept_p;
 
 typedef byte (*traverser_t)(intercept_t *in);
@@ -164,6 +163,11 @@ void P_UnsetThingPosition(mobj_t *thing);
 void P_SetThingPosition(mobj_t *thing);
 void P_SetThingPositionSubsector(mobj_t* thing, subsector_t *ss);
 
+extern msecnode_t *headsecnode; // free sector touching nodes
+
+byte P_ThingTouchesSector(mobj_t *thing, sector_t *sector);
+void P_CheckNeedClip(mobj_t *thing);
+
 //
 // P_MAP
 //
@@ -181,6 +185,8 @@ byte P_TryMove(mobj_t *thing, fixed_t x, fixed_t y);
 byte P_TeleportMove(mobj_t *thing, fixed_t x, fixed_t y);
 void P_SlideMove(mobj_t *mo);
 byte P_CheckSight(mobj_t *t1, mobj_t *t2);
+void P_ClearSightCache(void);
+void P_LogSightStats(void);
 void P_UseLines(void);
 
 byte P_ChangeSector(sector_t *sector, byte crunch);
@@ -213,6 +219,7 @@ extern int bmapheight; // in mapblocks
 extern fixed_t bmaporgx;
 extern fixed_t bmaporgy;    // origin of block map
 extern mobj_t **blocklinks; // for thing chains
+extern short *blockneedclip; // things with needclip set, per block
 
 // LUT bmapwidth muls
 extern int *bmapwidthmuls;
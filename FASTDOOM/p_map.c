@@ -493,6 +493,8 @@ byte P_ThingHeightClip(mobj_t *thing)
             thing->z = thing->ceilingz - thing->height;
     }
 
+    P_CheckNeedClip(thing);
+
     return (thing->ceilingz - thing->height >= thing->floorz);
 }
 
@@ -1320,21 +1322,94 @@ byte PIT_ChangeSector(mobj_t *thing)
     return 1;
 }
 
+//
+// PIT_ChangeTouching
+// Skips the things near the sector that do not touch it,
+// unless P_CheckNeedClip says a clip could still change them.
+//
+sector_t *changesector;
+
+byte PIT_ChangeTouching(mobj_t *thing)
+{
+    if (!thing->needclip && !P_ThingTouchesSector(thing, changesector))
+        return 1;
+
+    return PIT_ChangeSector(thing);
+}
+
 //
 // P_ChangeSector
+// Only the things touching the sector, and the ones P_CheckNeedClip
+// has flagged, can be affected by its move. The blockbox is walked
+// in the old order but only the blocks holding such things are
+// iterated, so things are clipped in the same order as before and
+// demos stay in sync.
 //
+#define MAXCHANGEBLOCKS 64
+
 byte P_ChangeSector(sector_t *sector, byte crunch)
 {
+    static int blocks[MAXCHANGEBLOCKS];
+    int numblocks;
+    int block;
+    int i;
+    int j;
     int x;
     int y;
+    msecnode_t *node;
+    mobj_t *thing;
 
     nofit = 0;
     crushchange = crunch;
+    changesector = sector;
+
+    // Sorted blocks holding things that touch the sector
+    numblocks = 0;
+    for (node = sector->touching_thinglist; node; node = node->m_tnext)
+    {
+        thing = node->m_thing;
+
+        x = (thing->x - bmaporgx) >> MAPBLOCKSHIFT;
+        y = (thing->y - bmaporgy) >> MAPBLOCKSHIFT;
+
+        if (x < sector->blockbox[BOXLEFT] || x > sector->blockbox[BOXRIGHT] || y < sector->blockbox[BOXBOTTOM] || y > sector->blockbox[BOXTOP])
+            continue;
+
+        block = x * bmapheight + y;
 
-    // re-check heights for all things near the moving sector
+        for (i = numblocks; i > 0 && blocks[i - 1] > block; i--)
+            ;
+
+        if (i > 0 && blocks[i - 1] == block)
+            continue;
+
+        if (numblocks == MAXCHANGEBLOCKS)
+        {
+            // too many, iterate every block
+            numblocks = -1;
+            break;
+        }
+
+        for (j = numblocks; j > i; j--)
+            blocks[j] = blocks[j - 1];
+
+        blocks[i] = block;
+        numblocks++;
+    }
+
+    i = 0;
     for (x = sector->blockbox[BOXLEFT]; x <= sector->blockbox[BOXRIGHT]; x++)
+    {
         for (y = sector->blockbox[BOXBOTTOM]; y <= sector->blockbox[BOXTOP]; y++)
-            P_NotBlockThingsIterator(x, y, PIT_ChangeSector);
+        {
+            if (i < numblocks && blocks[i] == x * bmapheight + y)
+                i++;
+            else if (numblocks >= 0 && !blockneedclip[bmapwidthmuls[y] + x])
+                continue;
+
+            P_NotBlockThingsIterator(x, y, PIT_ChangeTouching);
+        }
+    }
 
     return nofit;
 }
@@ -22,9 +22,11 @@
 #include <stdlib.h>
 #include "options.h"
 #include "m_misc.h"
+#include "i_system.h"
 
 #include "doomdef.h"
 #include "p_local.h"
+#include "z_zone.h"
 
 // State.
 #include "r_state.h"
@@ -226,6 +228,212 @@ void P_LineOpening(line_t *linedef)
     openrange = opentop - openbottom;
 }
 
+//
+// SECTOR TOUCHING LISTS
+// Every thing in the blockmap keeps the list of sectors its bounding
+// box touches, and every sector the list of things touching it,
+// so a moving sector only rechecks the things it can affect.
+//
+
+msecnode_t *headsecnode = NULL; // free nodes, cleared with the level
+
+static fixed_t secbbox[4];
+static mobj_t *secthing;
+
+//
+// P_AddSecnode
+// Links the thing and the sector unless they already are.
+//
+static void P_AddSecnode(sector_t *sector, mobj_t *thing)
+{
+    msecnode_t *node;
+
+    for (node = thing->touching_sectorlist; node; node = node->m_snext)
+    {
+        if (node->m_sector == sector)
+            return;
+    }
+
+    if (headsecnode)
+    {
+        node = headsecnode;
+        headsecnode = node->m_snext;
+    }
+    else
+    {
+        node = Z_MallocUnowned(sizeof(*node), PU_LEVEL);
+    }
+
+    node->m_sector = sector;
+    node->m_thing = thing;
+
+    // link into the thing's sectors
+    node->m_snext = thing->touching_sectorlist;
+    thing->touching_sectorlist = node;
+
+    // link into the sector's things
+    node->m_tprev = NULL;
+    node->m_tnext = sector->touching_thinglist;
+    if (node->m_tnext)
+        node->m_tnext->m_tprev = node;
+    sector->touching_thinglist = node;
+}
+
+//
+// PIT_GetSectors
+// Same line test as PIT_CheckLine, so the list holds every sector
+// P_CheckPosition could take the floor and ceiling from.
+//
+byte PIT_GetSectors(line_t *ld)
+{
+    if (secbbox[BOXRIGHT] <= ld->bbox[BOXLEFT] || secbbox[BOXLEFT] >= ld->bbox[BOXRIGHT] || secbbox[BOXTOP] <= ld->bbox[BOXBOTTOM] || secbbox[BOXBOTTOM] >= ld->bbox[BOXTOP] || P_BoxOnLineSide(secbbox, ld) != 2)
+        return 1;
+
+    P_AddSecnode(ld->frontsector, secthing);
+
+    if (ld->backsector)
+        P_AddSecnode(ld->backsector, secthing);
+
+    return 1;
+}
+
+//
+// P_CreateSecNodeList
+//
+static void P_CreateSecNodeList(mobj_t *thing, sector_t *sector)
+{
+    int xl;
+    int xh;
+    int yl;
+    int yh;
+    int bx;
+    int by;
+
+    secthing = thing;
+
+    secbbox[BOXTOP] = thing->y + thing->radius;
+    secbbox[BOXBOTTOM] = thing->y - thing->radius;
+    secbbox[BOXRIGHT] = thing->x + thing->radius;
+    secbbox[BOXLEFT] = thing->x - thing->radius;
+
+    P_AddSecnode(sector, thing);
+
+    validcount++;
+
+    xl = (secbbox[BOXLEFT] - bmaporgx) >> MAPBLOCKSHIFT;
+    xh = (secbbox[BOXRIGHT] - bmaporgx) >> MAPBLOCKSHIFT;
+    yl = (secbbox[BOXBOTTOM] - bmaporgy) >> MAPBLOCKSHIFT;
+    yh = (secbbox[BOXTOP] - bmaporgy) >> MAPBLOCKSHIFT;
+
+    for (bx = xl; bx <= xh; bx++)
+        for (by = yl; by <= yh; by++)
+            P_NotBlockLinesIterator(bx, by, PIT_GetSectors);
+}
+
+//
+// P_DelSeclist
+// Unlinks the thing from all the sectors it touches.
+//
+static void P_DelSeclist(mobj_t *thing)
+{
+    msecnode_t *node;
+    msecnode_t *next;
+
+    for (node = thing->touching_sectorlist; node; node = next)
+    {
+        next = node->m_snext;
+
+        if (node->m_tnext)
+            node->m_tnext->m_tprev = node->m_tprev;
+
+        if (node->m_tprev)
+            node->m_tprev->m_tnext = node->m_tnext;
+        else
+            node->m_sector->touching_thinglist = node->m_tnext;
+
+        node->m_snext = headsecnode;
+        headsecnode = node;
+    }
+
+    thing->touching_sectorlist = NULL;
+}
+
+//
+// P_ThingTouchesSector
+//
+byte P_ThingTouchesSector(mobj_t *thing, sector_t *sector)
+{
+    msecnode_t *node;
+
+    for (node = thing->touching_sectorlist; node; node = node->m_snext)
+    {
+        if (node->m_sector == sector)
+            return 1;
+    }
+
+    return 0;
+}
+
+//
+// P_SetNeedClip
+// Keeps blockneedclip in step, the thing must be linked where it is.
+//
+static void P_SetNeedClip(mobj_t *thing, byte needclip)
+{
+    int blockx;
+    int blocky;
+
+    if (thing->needclip == needclip)
+        return;
+
+    thing->needclip = needclip;
+
+    blockx = (thing->x - bmaporgx) >> MAPBLOCKSHIFT;
+    blocky = (thing->y - bmaporgy) >> MAPBLOCKSHIFT;
+
+    if (blockx >= 0 && blockx < bmapwidth && blocky >= 0 && blocky < bmapheight)
+    {
+        if (needclip)
+            blockneedclip[bmapwidthmuls[blocky] + blockx]++;
+        else
+            blockneedclip[bmapwidthmuls[blocky] + blockx]--;
+    }
+}
+
+//
+// P_CheckNeedClip
+// A moving sector the thing doesn't touch can only be skipped if
+// P_ThingHeightClip would give the thing back its floorz, ceilingz
+// and z however P_CheckPosition ends, early on a wall or another
+// thing or not. That holds when its own sector has its floorz and
+// ceilingz, no touched sector is higher or lower, it fits, and it
+// can't pick up or slam into anything.
+// Call it whenever any of these change for a thing in the blockmap.
+//
+void P_CheckNeedClip(mobj_t *thing)
+{
+    msecnode_t *node;
+    sector_t *sec;
+    byte needclip;
+
+    if (thing->flags & MF_NOBLOCKMAP)
+        return;
+
+    sec = thing->subsector->sector;
+
+    needclip = (thing->flags & (MF_PICKUP | MF_SKULLFLY)) ||
+               sec->floorheight != thing->floorz || sec->ceilingheight != thing->ceilingz ||
+               thing->z > thing->ceilingz - thing->height || thing->ceilingz - thing->floorz < thing->height;
+
+    for (node = thing->touching_sectorlist; node && !needclip; node = node->m_snext)
+    {
+        if (node->m_sector->floorheight > thing->floorz || node->m_sector->ceilingheight < thing->ceilingz)
+            needclip = 1;
+    }
+
+    P_SetNeedClip(thing, needclip);
+}
+
 //
 // THING POSITION SETTING
 //
@@ -255,8 +463,13 @@ void P_UnsetThingPosition(mobj_t *thing)
             thing->subsector->sector->thinglist = thing->snext;
     }
 
+    if (thing->touching_sectorlist)
+        P_DelSeclist(thing);
+
     if (!(thing->flags & MF_NOBLOCKMAP))
     {
+        P_SetNeedClip(thing, 0);
+
         // inert things don't need to be in blockmap
         // unlink from block map
         if (thing->bnext)
@@ -329,6 +542,10 @@ void P_SetThingPositionSubsector(mobj_t *thing, subsector_t *ss)
             // thing is off the map
             thing->bnext = thing->bprev = NULL;
         }
+
+        // only things in the blockmap are rechecked by moving sectors
+        P_CreateSecNodeList(thing, ss->sector);
+        P_CheckNeedClip(thing);
     }
 }
 
@@ -402,9 +619,32 @@ byte P_NotBlockThingsIterator(int x, int y, byte (*func)(mobj_t *))
 //
 // INTERCEPT ROUTINES
 //
-intercept_t intercepts[MAXINTERCEPTS];
+intercept_t *intercepts;
 intercept_t *intercept_p;
 
+static int maxintercepts;
+static int *interceptheap;
+
+//
+// P_GrowIntercepts
+// Doubles the intercepts array, and the heap used to
+// traverse it, instead of running past the end.
+//
+static void P_GrowIntercepts(void)
+{
+    int count = intercept_p - intercepts;
+
+    maxintercepts = maxintercepts ? maxintercepts * 2 : 128;
+
+    intercepts = realloc(intercepts, maxintercepts * sizeof(*intercepts));
+    interceptheap = realloc(interceptheap, maxintercepts * sizeof(*interceptheap));
+
+    if (!intercepts || !interceptheap)
+        I_Error("P_GrowIntercepts: no memory for %i intercepts", maxintercepts);
+
+    intercept_p = intercepts + count;
+}
+
 divline_t trace;
 
 //
@@ -450,6 +690,9 @@ byte PIT_AddLineIntercepts(line_t *ld)
     if (frac < 0)
         return 1; // behind source
 
+    if (intercept_p == intercepts + maxintercepts)
+        P_GrowIntercepts();
+
     intercept_p->frac = frac;
     intercept_p->isaline = 1;
     intercept_p->d.line = ld;
@@ -512,6 +755,9 @@ byte PIT_AddThingIntercepts(mobj_t *thing)
     if (frac < 0)
         return 1; // behind source
 
+    if (intercept_p == intercepts + maxintercepts)
+        P_GrowIntercepts();
+
     intercept_p->frac = frac;
     intercept_p->isaline = 0;
     intercept_p->d.thing = thing;
@@ -520,6 +766,35 @@ byte PIT_AddThingIntercepts(mobj_t *thing)
     return 1; // keep going
 }
 
+//
+// Intercepts are taken closest first, and in the order
+// they were added for equal fracs, from a binary heap
+// of their indices.
+//
+#define P_InterceptBefore(a, b) \
+    (intercepts[a].frac < intercepts[b].frac || (intercepts[a].frac == intercepts[b].frac && (a) < (b)))
+
+static void P_SiftIntercept(int i, int count)
+{
+    int *heap = interceptheap;
+    int node = heap[i];
+    int child;
+
+    while ((child = 2 * i + 1) < count)
+    {
+        if (child + 1 < count && P_InterceptBefore(heap[child + 1], heap[child]))
+            child++;
+
+        if (!P_InterceptBefore(heap[child], node))
+            break;
+
+        heap[i] = heap[child];
+        i = child;
+    }
+
+    heap[i] = node;
+}
+
 //
 // P_TraverseIntercepts
 // Returns true if the traverser function returns true
@@ -528,27 +803,29 @@ byte PIT_AddThingIntercepts(mobj_t *thing)
 void P_TraverseIntercepts(traverser_t func)
 {
     int count;
-    count = intercept_p - intercepts;
+    int i;
+    intercept_t *in;
 
-    while (count--)
+    // anything past the end of the trace is never reached
+    count = 0;
+    for (i = 0; i < intercept_p - intercepts; i++)
     {
-        fixed_t dist = MAXINT;
-        intercept_t *scan;
-        intercept_t *in;
+        if (intercepts[i].frac <= FRACUNIT)
+            interceptheap[count++] = i;
+    }
 
-        for (scan = intercepts; scan < intercept_p; scan++)
-        {
-            if (scan->frac < dist)
-            {
-                dist = scan->frac;
-                in = scan;
-            }
-        }
+    for (i = count / 2; i-- > 0;)
+        P_SiftIntercept(i, count);
+
+    while (count)
+    {
+        in = &intercepts[interceptheap[0]];
 
-        if (dist > FRACUNIT || !func(in))
-            return; // checked everything in range, don't bother going farther
+        if (!func(in))
+            return; // don't bother going farther
 
-        in->frac = MAXINT;
+        interceptheap[0] = interceptheap[--count];
+        P_SiftIntercept(0, count);
     }
 
     return; // everything was traversed
@@ -492,6 +492,15 @@ P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, byte type)
     else
         mobj->z = z;
 
+    // floorz is only from the sector until the first move
+    P_CheckNeedClip(mobj);
+
+    // nothing to interpolate from yet
+    mobj->oldx = mobj->x;
+    mobj->oldy = mobj->y;
+    mobj->oldz = mobj->z;
+    mobj->oldangle = mobj->angle;
+
     if (mobj->type < MT_MISC0)
     {
         mobj->thinker.function.acp1 = (actionf_p1)P_MobjThinker;
@@ -573,7 +582,7 @@ void P_SpawnPlayer(mapthing_t *mthing)
         mobj->flags |= (mthing->type - 1) << MF_TRANSSHIFT;
 
     // VITI95: OPTIMIZE
-    mobj->angle = ANG45 * (mthing->angle / 45);
+    mobj->angle = mobj->oldangle = ANG45 * (mthing->angle / 45);
     mobj->player = p;
     mobj->health = p->health;
 
@@ -270,6 +270,22 @@ typedef struct mobj_s
     // Thing being chased/attacked for tracers.
     struct mobj_s *tracer;
 
+    // Savegames end here, the fields below are set up again on load.
+
+    // Position at the start of the last tic,
+    // frames between tics are drawn in between.
+    fixed_t oldx;
+    fixed_t oldy;
+    fixed_t oldz;
+    angle_t oldangle;
+
+    // Sectors the bounding box touches (if in blockmap).
+    struct msecnode_s *touching_sectorlist;
+
+    // Counted in blockneedclip, a moving sector nearby must
+    // clip it even if it doesn't touch it.
+    byte needclip;
+
 } mobj_t;
 
 #endif
@@ -16,6 +16,7 @@
 //	Archiving: SaveGame I/O.
 //
 
+#include <stddef.h>
 #include <string.h>
 #include "options.h"
 #include "i_system.h"
@@ -32,6 +33,11 @@ byte *save_p;
 //  so that the load/save works on SGI&Gecko.
 #define PADSAVEP() save_p += (4 - ((int)save_p & 3)) & 3
 
+// Players and mobjs are saved up to their first field that is only
+//  used while the level runs, so saves keep the original layout.
+#define PLAYERSAVESIZE offsetof(player_t, oldviewz)
+#define MOBJSAVESIZE offsetof(mobj_t, oldx)
+
 //
 // P_ArchivePlayers
 //
@@ -43,9 +49,9 @@ void P_ArchivePlayers(void)
 	PADSAVEP();
 
 	dest = (player_t *)save_p;
-	CopyBytes(&players, dest, sizeof(player_t));
+	CopyBytes(&players, dest, PLAYERSAVESIZE);
 	//memcpy(dest, &players, sizeof(player_t));
-	save_p += sizeof(player_t);
+	save_p += PLAYERSAVESIZE;
 	for (j = 0; j < NUMPSPRITES; j++)
 	{
 		if (dest->psprites[j].state)
@@ -64,9 +70,10 @@ void P_UnArchivePlayers(void)
 
 	PADSAVEP();
 
-	CopyBytes(save_p, &players, sizeof(player_t));
+	CopyBytes(save_p, &players, PLAYERSAVESIZE);
 	//memcpy(&players, save_p, sizeof(player_t));
-	save_p += sizeof(player_t);
+	save_p += PLAYERSAVESIZE;
+	players.oldviewz = players.viewz;
 
 	// will be set when unarc thinker
 	players_mo = NULL;
@@ -208,9 +215,9 @@ void P_ArchiveThinkers(void)
 			*save_p++ = tc_mobj;
 			PADSAVEP();
 			mobj = (mobj_t *)save_p;
-			CopyBytes(th, mobj, sizeof(*mobj));
+			CopyBytes(th, mobj, MOBJSAVESIZE);
 			//memcpy(mobj, th, sizeof(*mobj));
-			save_p += sizeof(*mobj);
+			save_p += MOBJSAVESIZE;
 			mobj->state = (state_t *)(mobj->state - states);
 
 			if (mobj->player)
@@ -260,11 +267,17 @@ void P_UnArchiveThinkers(void)
 		case tc_mobj:
 			PADSAVEP();
 			mobj = Z_MallocUnowned(sizeof(*mobj), PU_LEVEL);
-			CopyBytes(save_p, mobj, sizeof(*mobj));
+			CopyBytes(save_p, mobj, MOBJSAVESIZE);
 			//memcpy(mobj, save_p, sizeof(*mobj));
-			save_p += sizeof(*mobj);
+			save_p += MOBJSAVESIZE;
 			mobj->state = &states[(int)mobj->state];
 			mobj->target = NULL;
+			mobj->oldx = mobj->x;
+			mobj->oldy = mobj->y;
+			mobj->oldz = mobj->z;
+			mobj->oldangle = mobj->angle;
+			mobj->touching_sectorlist = NULL;
+			mobj->needclip = 0;
 			if (mobj->player)
 			{
 				mobj->player = &players;
@@ -275,6 +288,7 @@ void P_UnArchiveThinkers(void)
 			mobj->info = &mobjinfo[mobj->type];
 			mobj->floorz = mobj->subsector->sector->floorheight;
 			mobj->ceilingz = mobj->subsector->sector->ceilingheight;
+			P_CheckNeedClip(mobj);
 			mobj->thinker.function.acp1 = (actionf_p1)P_MobjThinker;
 
 			thinkercap.prev->next = &mobj->thinker;
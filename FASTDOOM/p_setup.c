@@ -33,11 +33,16 @@
 
 #include "doomdef.h"
 #include "p_local.h"
+#include "p_tick.h"
 
 #include "s_sound.h"
 
 #include "doomstat.h"
 
+#include "am_map.h"
+
+#include "ns_task.h"
+
 void P_SpawnMapThing(mapthing_t *mthing);
 
 //
@@ -82,6 +87,7 @@ fixed_t bmaporgx;
 fixed_t bmaporgy;
 // for thing chains
 mobj_t **blocklinks;
+short *blockneedclip;
 // LUT bmapwidth muls
 int *bmapwidthmuls;
 
@@ -94,6 +100,160 @@ int *bmapwidthmuls;
 //
 byte *rejectmatrix;
 
+//
+// Level load profiling
+// With -loadprofile every setup stage is timed in PIT clocks,
+// along with the lump reads and zone purges it caused.
+//
+#define MAXLOADSTAGES 24
+
+typedef struct
+{
+    char *name;
+    unsigned long clocks;
+    int reads;
+    int bytes;
+    int purges;
+} loadstage_t;
+
+static loadstage_t loadstages[MAXLOADSTAGES];
+static int numloadstages;
+static unsigned long loadclock;
+static int loadreads;
+static int loadbytes;
+static int loadpurges;
+
+//
+// A nested part of a stage, timed around each call and
+// accumulated until P_LoadSubStage splits it out
+//
+static loadstage_t substage;
+static unsigned long subclock;
+static int subreads;
+static int subbytes;
+static int subpurges;
+
+void P_BeginLoadProfile(void)
+{
+    if (!loadProfile)
+        return;
+
+    numloadstages = 0;
+    loadclock = TS_GetClock();
+    loadreads = lumpreads;
+    loadbytes = lumpreadbytes;
+    loadpurges = zonepurges;
+
+    substage.clocks = 0;
+    substage.reads = substage.bytes = substage.purges = 0;
+}
+
+void P_LoadStage(char *name)
+{
+    unsigned long clock;
+    loadstage_t *stage;
+
+    if (!loadProfile || numloadstages == MAXLOADSTAGES)
+        return;
+
+    clock = TS_GetClock();
+
+    stage = &loadstages[numloadstages++];
+    stage->name = name;
+    stage->clocks = clock - loadclock;
+    stage->reads = lumpreads - loadreads;
+    stage->bytes = lumpreadbytes - loadbytes;
+    stage->purges = zonepurges - loadpurges;
+
+    loadclock = clock;
+    loadreads = lumpreads;
+    loadbytes = lumpreadbytes;
+    loadpurges = zonepurges;
+}
+
+void P_BeginSubStage(void)
+{
+    if (!loadProfile)
+        return;
+
+    subclock = TS_GetClock();
+    subreads = lumpreads;
+    subbytes = lumpreadbytes;
+    subpurges = zonepurges;
+}
+
+void P_EndSubStage(void)
+{
+    if (!loadProfile)
+        return;
+
+    substage.clocks += TS_GetClock() - subclock;
+    substage.reads += lumpreads - subreads;
+    substage.bytes += lumpreadbytes - subbytes;
+    substage.purges += zonepurges - subpurges;
+}
+
+void P_LoadSubStage(char *name)
+{
+    loadstage_t *stage;
+
+    if (!loadProfile || !numloadstages || numloadstages == MAXLOADSTAGES)
+        return;
+
+    // Take it out of the stage that was just closed
+    stage = &loadstages[numloadstages - 1];
+    stage->clocks -= substage.clocks;
+    stage->reads -= substage.reads;
+    stage->bytes -= substage.bytes;
+    stage->purges -= substage.purges;
+
+    stage = &loadstages[numloadstages++];
+    *stage = substage;
+    stage->name = name;
+
+    substage.clocks = 0;
+    substage.reads = substage.bytes = substage.purges = 0;
+}
+
+void P_EndLoadProfile(char *lumpname)
+{
+    FILE *logFile;
+    loadstage_t *stage;
+    loadstage_t total;
+    int i;
+
+    if (!loadProfile)
+        return;
+
+    logFile = fopen("loadprof.txt", "a");
+    if (!logFile)
+        return;
+
+    total.clocks = 0;
+    total.reads = total.bytes = total.purges = 0;
+
+    fprintf(logFile, "# %s\n", lumpname);
+    fprintf(logFile, "# stage,ms,reads,bytes,purges\n");
+
+    for (i = 0, stage = loadstages; i < numloadstages; i++, stage++)
+    {
+        fprintf(logFile, "%s,%lu.%i,%i,%i,%i\n", stage->name,
+                stage->clocks / PITCLOCKSPERMS, Mul10(stage->clocks % PITCLOCKSPERMS) / PITCLOCKSPERMS,
+                stage->reads, stage->bytes, stage->purges);
+
+        total.clocks += stage->clocks;
+        total.reads += stage->reads;
+        total.bytes += stage->bytes;
+        total.purges += stage->purges;
+    }
+
+    fprintf(logFile, "total,%lu.%i,%i,%i,%i\n",
+            total.clocks / PITCLOCKSPERMS, Mul10(total.clocks % PITCLOCKSPERMS) / PITCLOCKSPERMS,
+            total.reads, total.bytes, total.purges);
+
+    fclose(logFile);
+}
+
 //
 // P_LoadVertexes
 //
@@ -456,6 +616,10 @@ void P_LoadBlockMap(int lump)
     blocklinks = Z_MallocUnowned(count, PU_LEVEL);
     memset(blocklinks, 0, count);
 
+    count = sizeof(*blockneedclip) * bmapwidth * bmapheight;
+    blockneedclip = Z_MallocUnowned(count, PU_LEVEL);
+    memset(blockneedclip, 0, count);
+
     // LUT bmapwidth muls
     count = sizeof(int) * bmapheight;
     bmapwidthmuls = Z_MallocUnowned(count, PU_LEVEL);
@@ -469,18 +633,20 @@ void P_LoadBlockMap(int lump)
 // P_GroupLines
 // Builds sector line lists and subsector sector numbers.
 // Finds block bounding boxes for sectors.
+// Lines are counted per sector, then scattered into linebuffer
+// in a single pass, keeping each sector's lines in linedef order.
 //
 void P_GroupLines(void)
 {
     line_t **linebuffer;
     int i;
-    int j;
     int total;
     line_t *li;
     sector_t *sector;
     subsector_t *ss;
     seg_t *seg;
-    fixed_t bbox[4];
+    fixed_t *bboxes;
+    fixed_t *bbox;
     int block;
 
     // look up sector number for each subsector
@@ -505,26 +671,46 @@ void P_GroupLines(void)
         }
     }
 
-    // build line tables for each sector
+    // build line tables for each sector,
+    // linecount is reused as fill cursor
     linebuffer = Z_MallocUnowned(total * 4, PU_LEVEL);
+    bboxes = Z_MallocUnowned(numsectors * 4 * sizeof(fixed_t), PU_STATIC);
+
     sector = sectors;
-    for (i = 0; i < numsectors; i++, sector++)
+    bbox = bboxes;
+    for (i = 0; i < numsectors; i++, sector++, bbox += 4)
     {
+        sector->lines = linebuffer;
+        linebuffer += sector->linecount;
+        sector->linecount = 0;
+
         bbox[BOXTOP] = bbox[BOXRIGHT] = MININT;
         bbox[BOXBOTTOM] = bbox[BOXLEFT] = MAXINT;
+    }
 
-        sector->lines = linebuffer;
-        li = lines;
-        for (j = 0; j < numlines; j++, li++)
+    li = lines;
+    for (i = 0; i < numlines; i++, li++)
+    {
+        sector = li->frontsector;
+        sector->lines[sector->linecount++] = li;
+        bbox = bboxes + (sector - sectors) * 4;
+        M_AddToBox(bbox, li->v1->x, li->v1->y);
+        M_AddToBox(bbox, li->v2->x, li->v2->y);
+
+        sector = li->backsector;
+        if (sector && sector != li->frontsector)
         {
-            if (li->frontsector == sector || li->backsector == sector)
-            {
-                *linebuffer++ = li;
-                M_AddToBox(bbox, li->v1->x, li->v1->y);
-                M_AddToBox(bbox, li->v2->x, li->v2->y);
-            }
+            sector->lines[sector->linecount++] = li;
+            bbox = bboxes + (sector - sectors) * 4;
+            M_AddToBox(bbox, li->v1->x, li->v1->y);
+            M_AddToBox(bbox, li->v2->x, li->v2->y);
         }
+    }
 
+    sector = sectors;
+    bbox = bboxes;
+    for (i = 0; i < numsectors; i++, sector++, bbox += 4)
+    {
         // set the degenmobj_t to the middle of the bounding box
         sector->soundorg.x = (bbox[BOXRIGHT] + bbox[BOXLEFT]) / 2;
         sector->soundorg.y = (bbox[BOXTOP] + bbox[BOXBOTTOM]) / 2;
@@ -546,6 +732,8 @@ void P_GroupLines(void)
         block = block < 0 ? 0 : block;
         sector->blockbox[BOXLEFT] = block;
     }
+
+    Z_Free(bboxes);
 }
 
 //
@@ -560,6 +748,8 @@ void P_SetupLevel(int episode,
     char lumpname[9];
     int lumpnum;
 
+    P_BeginLoadProfile();
+
     totalkills = totalitems = totalsecret = 0;
     wminfo.partime = 180;
 
@@ -574,8 +764,12 @@ void P_SetupLevel(int episode,
     S_ClearSounds();
 
     Z_FreeTags(PU_LEVEL, PU_PURGELEVEL - 1);
+    headsecnode = NULL;
+    P_ClearSightCache();
 
     P_InitThinkers();
+    interptic = -1;
+    P_LoadStage("free level");
 
     // find map name
     if (gamemode == commercial)
@@ -600,28 +794,50 @@ void P_SetupLevel(int episode,
 
     // note: most of this ordering is important
     P_LoadBlockMap(lumpnum + ML_BLOCKMAP);
+    P_LoadStage("P_LoadBlockMap");
     P_LoadVertexes(lumpnum + ML_VERTEXES);
+    P_LoadStage("P_LoadVertexes");
     P_LoadSectors(lumpnum + ML_SECTORS);
+    P_LoadStage("P_LoadSectors");
+    P_InitTagLists();
+    P_LoadStage("P_InitTagLists");
     P_LoadSideDefs(lumpnum + ML_SIDEDEFS);
+    P_LoadStage("P_LoadSideDefs");
 
     P_LoadLineDefs(lumpnum + ML_LINEDEFS);
+    P_LoadStage("P_LoadLineDefs");
     P_LoadSubsectors(lumpnum + ML_SSECTORS);
+    P_LoadStage("P_LoadSubsectors");
     P_LoadNodes(lumpnum + ML_NODES);
+    P_LoadStage("P_LoadNodes");
     P_LoadSegs(lumpnum + ML_SEGS);
+    P_LoadStage("P_LoadSegs");
 
     rejectmatrix = W_CacheLumpNum(lumpnum + ML_REJECT, PU_LEVEL);
+    P_LoadStage("reject");
     P_GroupLines();
+    P_LoadStage("P_GroupLines");
+    AM_InitLineCache();
+    P_LoadStage("AM_InitLineCache");
 
     P_LoadThings(lumpnum + ML_THINGS);
+    P_LoadStage("P_LoadThings");
 
     // clear special respawning que
     iquehead = iquetail = 0;
 
     // set up world state
     P_SpawnSpecials();
+    P_LoadStage("P_SpawnSpecials");
 
-    // preload graphics
+    // pin the flats, then preload graphics
+    R_InitFlatCache();
+    P_LoadStage("R_InitFlatCache");
+    R_InitInterpolation();
+    P_LoadStage("R_InitInterpolation");
     R_PrecacheLevel();
+
+    P_EndLoadProfile(lumpname);
 }
 
 const char *sprnames[NUMSPRITES] = {
@@ -28,4 +28,13 @@ void P_SetupLevel(int episode,
 // Called by startup code.
 void P_Init(void);
 
+// Closes the current level load stage for -loadprofile.
+void P_LoadStage(char *name);
+
+// Times a nested part of a stage, reported as its own
+// row after the stage by P_LoadSubStage.
+void P_BeginSubStage(void);
+void P_EndSubStage(void);
+void P_LoadSubStage(char *name);
+
 #endif
@@ -17,8 +17,11 @@
 //
 
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
 #include "options.h"
 #include "doomdef.h"
+#include "doomstat.h"
 
 #include "i_system.h"
 #include "p_local.h"
@@ -39,6 +42,107 @@ divline_t strace; // from t1 to t2
 fixed_t t2x;
 fixed_t t2y;
 
+//
+// Sight check cache
+// A sight check only depends on both positions and on the
+// heights of the sectors its trace went through, so the result
+// is kept along with them and reused until one of them changes.
+//
+#define SIGHTCACHESIZE 64
+#define MAXSIGHTSECTORS 12
+
+typedef struct
+{
+    sector_t *sector;
+    fixed_t floorheight;
+    fixed_t ceilingheight;
+} sightsector_t;
+
+typedef struct
+{
+    mobj_t *t1;
+    mobj_t *t2;
+    fixed_t x1;
+    fixed_t y1;
+    fixed_t z1;
+    fixed_t height1;
+    fixed_t x2;
+    fixed_t y2;
+    fixed_t z2;
+    fixed_t height2;
+    int numtouched;
+    sightsector_t touched[MAXSIGHTSECTORS];
+    byte result;
+} sightcache_t;
+
+static sightcache_t sightcache[SIGHTCACHESIZE];
+
+// Sectors the current trace went through,
+// more than MAXSIGHTSECTORS if it can't be cached
+static sightsector_t sightsectors[MAXSIGHTSECTORS];
+static int numsightsectors;
+
+int sighthits;
+int sightmisses;
+int sightuncached;
+
+static void P_AddSightSector(sector_t *sector)
+{
+    sightsector_t *touched;
+
+    if (numsightsectors > MAXSIGHTSECTORS)
+        return;
+
+    if (numsightsectors && sightsectors[numsightsectors - 1].sector == sector)
+        return;
+
+    if (numsightsectors == MAXSIGHTSECTORS)
+    {
+        numsightsectors++;
+        return;
+    }
+
+    touched = &sightsectors[numsightsectors++];
+    touched->sector = sector;
+    touched->floorheight = sector->floorheight;
+    touched->ceilingheight = sector->ceilingheight;
+}
+
+//
+// P_ClearSightCache
+// The cached sectors belong to the level being left.
+//
+void P_ClearSightCache(void)
+{
+    memset(sightcache, 0, sizeof(sightcache));
+}
+
+//
+// P_LogSightStats
+// Appends the sight cache statistics to sightsta.txt and starts over.
+//
+void P_LogSightStats(void)
+{
+    FILE *logFile;
+    int total;
+
+    total = sighthits + sightmisses;
+
+    if (!sightStats || !total)
+        return;
+
+    logFile = fopen("sightsta.txt", "a");
+    if (logFile)
+    {
+        fprintf(logFile, "E%iM%i: %i checks, %i hits (%i%%), %i misses, %i too long to cache\n",
+                gameepisode, gamemap, total, sighthits, (sighthits * 100) / total,
+                sightmisses, sightuncached);
+        fclose(logFile);
+    }
+
+    sighthits = sightmisses = sightuncached = 0;
+}
+
 //
 // P_CrossSubsector
 // Returns true
@@ -116,6 +220,9 @@ byte P_CrossSubsector(int num)
         front = seg->frontsector;
         back = seg->backsector;
 
+        P_AddSightSector(front);
+        P_AddSightSector(back);
+
         // no wall to block sight with?
         if (front->floorheight == back->floorheight && front->ceilingheight == back->ceilingheight)
             continue;
@@ -258,6 +365,9 @@ byte P_CheckSight(mobj_t *t1, mobj_t *t2)
     int pnum;
     int bytenum;
     int bitnum;
+    int i;
+    byte result;
+    sightcache_t *entry;
 
     // First check for trivial rejection.
 
@@ -275,10 +385,35 @@ byte P_CheckSight(mobj_t *t1, mobj_t *t2)
         return 0;
     }
 
+    // Reuse the last result for this pair if
+    // nothing it depended on has moved since.
+    entry = &sightcache[(((unsigned)t1 >> 3) ^ ((unsigned)t2 >> 5)) & (SIGHTCACHESIZE - 1)];
+
+    if (entry->t1 == t1 && entry->t2 == t2 &&
+        entry->x1 == t1->x && entry->y1 == t1->y && entry->z1 == t1->z && entry->height1 == t1->height &&
+        entry->x2 == t2->x && entry->y2 == t2->y && entry->z2 == t2->z && entry->height2 == t2->height)
+    {
+        for (i = 0; i < entry->numtouched; i++)
+        {
+            if (entry->touched[i].sector->floorheight != entry->touched[i].floorheight ||
+                entry->touched[i].sector->ceilingheight != entry->touched[i].ceilingheight)
+                break;
+        }
+
+        if (i == entry->numtouched)
+        {
+            sighthits++;
+            return entry->result;
+        }
+    }
+
+    sightmisses++;
+
     // An unobstructed LOS is possible.
     // Now look from eyes of t1 to any part of t2.
 
     validcount++;
+    numsightsectors = 0;
 
     sightzstart = t1->z + t1->height - (t1->height >> 2);
     topslope = (t2->z + t2->height) - sightzstart;
@@ -292,5 +427,28 @@ byte P_CheckSight(mobj_t *t1, mobj_t *t2)
     strace.dy = t2y - t1->y;
 
     // the head node is the last node output
-    return P_CrossBSPNode(firstnode);
+    result = P_CrossBSPNode(firstnode);
+
+    if (numsightsectors > MAXSIGHTSECTORS)
+    {
+        sightuncached++;
+        entry->t1 = NULL;
+        return result;
+    }
+
+    entry->t1 = t1;
+    entry->t2 = t2;
+    entry->x1 = t1->x;
+    entry->y1 = t1->y;
+    entry->z1 = t1->z;
+    entry->height1 = t1->height;
+    entry->x2 = t2->x;
+    entry->y2 = t2->y;
+    entry->z2 = t2->z;
+    entry->height2 = t2->height;
+    entry->numtouched = numsightsectors;
+    memcpy(entry->touched, sightsectors, numsightsectors * sizeof(sightsector_t));
+    entry->result = result;
+
+    return result;
 }
@@ -170,6 +170,35 @@ void P_InitPicAnims(void)
 	}
 }
 
+//
+// P_MarkAnimFlats
+// Marks every frame of the flat animations that
+//  have at least one frame marked in flatpresent.
+//
+void P_MarkAnimFlats(byte *flatpresent)
+{
+	anim_t *anim;
+	int i;
+
+	for (anim = anims; anim < lastanim; anim++)
+	{
+		if (anim->istexture)
+			continue;
+
+		for (i = anim->basepic; i < anim->lastpic; i++)
+		{
+			if (flatpresent[i])
+				break;
+		}
+
+		if (i == anim->lastpic)
+			continue;
+
+		for (i = anim->basepic; i < anim->lastpic; i++)
+			flatpresent[i] = 1;
+	}
+}
+
 //
 // UTILITIES
 //
@@ -355,17 +384,43 @@ fixed_t P_FindHighestCeilingSurrounding(sector_t *sec)
 
 //
 // RETURN NEXT SECTOR # THAT LINE TAG REFERS TO
+// The sectors are chained by tag in ascending order. When start
+// has another tag (EV_BuildStairs passes the last step back),
+// the line's chain is walked up to the first sector after it.
 //
-
 int P_FindSectorFromLineTag(line_t *line, int start)
 {
 	int i;
 
-	for (i = start + 1; i < numsectors; i++)
-		if (sectors[i].tag == line->tag)
-			return i;
+	if (start >= 0 && sectors[start].tag == line->tag)
+		i = sectors[start].nexttag;
+	else
+		i = sectors[(unsigned)line->tag % (unsigned)numsectors].firsttag;
+
+	while (i >= 0 && (i <= start || sectors[i].tag != line->tag))
+		i = sectors[i].nexttag;
+
+	return i;
+}
+
+//
+// P_InitTagLists
+// Chains the sectors sharing tag % numsectors, lowest index first.
+//
+void P_InitTagLists(void)
+{
+	int i;
+	int j;
+
+	for (i = numsectors; --i >= 0;)
+		sectors[i].firsttag = -1;
 
-	return -1;
+	for (i = numsectors; --i >= 0;)
+	{
+		j = (unsigned)sectors[i].tag % (unsigned)numsectors;
+		sectors[i].nexttag = sectors[j].firsttag;
+		sectors[j].firsttag = i;
+	}
 }
 
 //
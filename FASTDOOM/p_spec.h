@@ -28,6 +28,9 @@
 // at game start
 void P_InitPicAnims(void);
 
+// at map load, for the flat cache
+void P_MarkAnimFlats(byte *flatpresent);
+
 // at map load
 void P_SpawnSpecials(void);
 
@@ -70,6 +73,8 @@ fixed_t P_FindHighestCeilingSurrounding(sector_t *sec);
 int P_FindSectorFromLineTag(line_t *line,
                             int start);
 
+void P_InitTagLists(void);
+
 int P_FindMinSurroundingLight(sector_t *sector,
                               int max);
 
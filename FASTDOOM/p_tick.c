@@ -21,6 +21,9 @@
 #include "p_local.h"
 #include "options.h"
 #include "doomstat.h"
+#include "i_random.h"
+#include "g_game.h"
+#include "p_tick.h"
 
 int leveltime;
 
@@ -78,6 +81,94 @@ void P_RunThinkers(void)
 // P_Ticker
 //
 
+#define DC_HASH(h, v) ((h) = (((h) << 5) | ((h) >> 27)) ^ (unsigned int)(v))
+
+//
+// P_ChecksumTic
+// Only state that feeds back into the sim is hashed,
+// so renderer changes never affect the result.
+//
+void P_ChecksumTic(unsigned int *sums)
+{
+    int i;
+    unsigned int h;
+    thinker_t *th;
+    mobj_t *mo;
+    sector_t *sec;
+
+    h = 0;
+    DC_HASH(h, players_mo->x);
+    DC_HASH(h, players_mo->y);
+    DC_HASH(h, players_mo->z);
+    DC_HASH(h, players_mo->angle);
+    DC_HASH(h, players_mo->momx);
+    DC_HASH(h, players_mo->momy);
+    DC_HASH(h, players.health);
+    DC_HASH(h, players.armorpoints);
+    sums[DC_PLAYER] = h;
+
+    sums[DC_RANDOM] = prndindex;
+
+    h = 0;
+    for (th = thinkercap.next; th != &thinkercap; th = th->next)
+    {
+        if (th->function.acp1 != (actionf_p1)P_MobjThinker && th->function.acp1 != (actionf_p1)P_MobjBrainlessThinker && th->function.acp1 != (actionf_p1)P_MobjTicklessThinker)
+            continue;
+
+        mo = (mobj_t *)th;
+        DC_HASH(h, mo->type);
+        DC_HASH(h, mo->x);
+        DC_HASH(h, mo->y);
+        DC_HASH(h, mo->z);
+        DC_HASH(h, mo->health);
+    }
+    sums[DC_MOBJS] = h;
+
+    h = 0;
+    for (i = 0, sec = sectors; i < numsectors; i++, sec++)
+    {
+        DC_HASH(h, sec->floorheight);
+        DC_HASH(h, sec->ceilingheight);
+    }
+    sums[DC_SECTORS] = h;
+}
+
+//
+// P_SaveInterpolation
+// Only the renderer reads the old positions, so
+// interpolation never feeds back into the game.
+//
+int interptic = -1;
+
+void P_SaveInterpolation(void)
+{
+    int i;
+    thinker_t *th;
+    mobj_t *mo;
+    sector_t *sec;
+
+    for (th = thinkercap.next; th != &thinkercap; th = th->next)
+    {
+        if (th->function.acp1 != (actionf_p1)P_MobjThinker && th->function.acp1 != (actionf_p1)P_MobjBrainlessThinker && th->function.acp1 != (actionf_p1)P_MobjTicklessThinker)
+            continue;
+
+        mo = (mobj_t *)th;
+        mo->oldx = mo->x;
+        mo->oldy = mo->y;
+        mo->oldz = mo->z;
+        mo->oldangle = mo->angle;
+    }
+
+    for (i = 0, sec = sectors; i < numsectors; i++, sec++)
+    {
+        sec->oldfloorheight = sec->floorheight;
+        sec->oldceilingheight = sec->ceilingheight;
+    }
+
+    players.oldviewz = players.viewz;
+    interptic = gametic;
+}
+
 void P_Ticker(void)
 {
     int i;
@@ -86,6 +177,9 @@ void P_Ticker(void)
     if (paused || (menuactive && !demoplayback && players.viewz != 1))
         return;
 
+    if (uncappedFPS && !singletics)
+        P_SaveInterpolation();
+
     P_PlayerThink();
 
     P_RunThinkers();
@@ -93,4 +187,7 @@ void P_Ticker(void)
 
     // for par times
     leveltime++;
+
+    if (demoCheck && demoplayback)
+        G_DemoCheckTic();
 }
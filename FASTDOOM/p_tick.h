@@ -24,4 +24,24 @@
 // Carries out all thinking of monsters and players.
 void P_Ticker(void);
 
+// Demo checksum subsystems, compared separately
+// so a desync report can name what diverged.
+enum
+{
+    DC_PLAYER,
+    DC_RANDOM,
+    DC_MOBJS,
+    DC_SECTORS,
+    NUMDEMOCHECKS
+};
+
+// Hashes the sim state of the current tic.
+void P_ChecksumTic(unsigned int *sums);
+
+// gametic of the last P_SaveInterpolation, -1 if none this level
+extern int interptic;
+
+// Keeps what the renderer interpolates from, before a tic runs.
+void P_SaveInterpolation(void);
+
 #endif
@@ -459,6 +459,309 @@ CODE_SYM_DEF R_DrawSpan
   ret
 ; R_DrawSpan ends
 
+CONTINUE_DATA_SECTION
+
+colend:     dd 0
+spanend:    dd 0
+
+CONTINUE_CODE_SECTION
+
+; ===========================================================================
+; R_DrawColumn486
+; vertical texture mapping, full resolution
+; One pixel per iteration with the count in a register,
+; the 486 has no second pipe to pair into and pays for
+; the memory decrement and the patched immediates
+; ===========================================================================
+CODE_SYM_DEF R_DrawColumn486
+  pushad
+
+  mov  ebp,[_dc_yl]
+  mov  ebx,[_dc_x]
+  lea  edi,[ebp+ebp*4]
+  mov  cl,bl
+  shl  edi,4
+  shr  ebx,2
+  and  cl,3
+  add  edi,ebx
+  mov  eax,1
+  mov  edx,SC_INDEX+1
+  shl  eax,cl
+  add  edi,[_destview]
+  out  dx,al
+  mov  eax,ebp
+  mov  ebp,[_dc_yh]
+  sub  ebp,eax              ; ebp = pixel count - 1
+  js   short .done
+
+  mov  ecx,[_dc_iscale]
+  sub  eax,[_centery]
+  imul ecx
+  mov  edx,[_dc_texturemid]
+  shl  ecx,9 ; 7 significant bits, 25 frac
+  add  edx,eax
+  mov  esi,[_dc_source]
+  shl  edx,9 ; 7 significant bits, 25 frac
+  mov  eax,[_dc_colormap]
+  inc  ebp                  ; ebp = pixel count
+
+.loop:
+  mov  ebx,edx
+  add  edx,ecx              ; calculate next location
+  shr  ebx,25
+  add  edi,SCREENWIDTH/4
+  mov  al,[esi+ebx]         ; get source pixel
+  mov  al,[eax]             ; translate the color
+  dec  ebp
+  mov  [edi-SCREENWIDTH/4],al
+  jnz  short .loop
+
+.done:
+  popad
+  ret
+; R_DrawColumn486 ends
+
+; ===========================================================================
+; R_DrawColumnPentium
+; vertical texture mapping, full resolution
+; Same pairing as R_DrawColumnPentium_13h, two pixels
+; per iteration and both eax and ebx carry the colormap
+; ===========================================================================
+CODE_SYM_DEF R_DrawColumnPentium
+  pushad
+
+  mov  ebp,[_dc_yl]
+  mov  ebx,[_dc_x]
+  lea  edi,[ebp+ebp*4]
+  mov  cl,bl
+  shl  edi,4
+  shr  ebx,2
+  and  cl,3
+  add  edi,ebx
+  mov  eax,1
+  mov  edx,SC_INDEX+1
+  shl  eax,cl
+  add  edi,[_destview]
+  out  dx,al
+  mov  eax,ebp
+  mov  ebp,[_dc_yh]
+  sub  ebp,eax              ; ebp = pixel count - 1
+  js   short .done
+
+  mov  ecx,[_dc_iscale]
+  sub  eax,[_centery]
+  imul ecx
+  mov  edx,[_dc_texturemid]
+  shl  ecx,9 ; 7 significant bits, 25 frac
+  add  edx,eax
+  lea  ebp,[ebp+ebp*4]
+  shl  edx,9 ; 7 significant bits, 25 frac
+  shl  ebp,4
+  mov  esi,[_dc_source]
+  add  ebp,edi              ; ebp = bottom pixel
+  mov  eax,[_dc_colormap]
+  mov  [colend],ebp
+  mov  ebx,eax
+  cmp  edi,ebp
+  jae  short .last
+
+.loop:
+  mov  ebp,edx
+  add  edx,ecx              ; calculate next location
+  shr  ebp,25
+  add  edi,SCREENWIDTH/2
+  mov  al,[esi+ebp]         ; get first source pixel
+  mov  ebp,edx
+  shr  ebp,25
+  add  edx,ecx
+  mov  bl,[esi+ebp]         ; get second source pixel
+  mov  al,[eax]             ; translate both colors
+  mov  bl,[ebx]
+  mov  [edi-SCREENWIDTH/2],al
+  mov  [edi-SCREENWIDTH/4],bl
+  cmp  edi,[colend]
+  jb   short .loop
+  ja   short .done          ; even count, nothing left
+
+.last:
+  shr  edx,25
+  mov  al,[esi+edx]
+  mov  al,[eax]
+  mov  [edi],al
+
+.done:
+  popad
+  ret
+; R_DrawColumnPentium ends
+
+; ===========================================================================
+; R_DrawSpan486
+; horizontal texture mapping, full detail
+; Draws the span one plane at a time, a single pixel per
+; iteration with the count in ebx. Keeps the shld pair,
+; which costs the 486 less than a shr/and/shr/or chain
+; ===========================================================================
+CODE_SYM_DEF R_DrawSpan486
+  pushad
+
+  mov  eax,[_ds_y]
+  mov  ebx,[_ds_x1]
+  lea  edi,[eax+eax*4]
+  mov  ecx,[_ds_frac]
+  shl  edi,4
+  mov  [curx],ebx
+  add  edi,[_destview]
+  add  ebx,4
+  mov  [frac],ecx
+  mov  [dest],edi           ; start of the row
+  mov  [endplane],ebx
+
+.plane:
+  mov  ebx,[curx]
+  mov  ebp,[_ds_x2]
+  mov  cl,bl
+  sub  ebp,ebx
+  js   .done
+  mov  eax,1
+  and  cl,3
+  mov  edx,SC_INDEX+1
+  shl  eax,cl
+  out  dx,al
+  shr  ebx,2
+  mov  edi,[dest]
+  shr  ebp,2
+  add  edi,ebx              ; first pixel in this plane
+  lea  ebx,[ebp+1]          ; ebx = pixel count in this plane
+  mov  ebp,[frac]
+  mov  edx,[_ds_step]
+  mov  esi,[_ds_source]
+  shl  edx,2                ; four pixels apart in the plane
+  mov  eax,[_ds_colormap]
+
+.loop:
+  shld ecx,ebp,22
+  shld ecx,ebp,6
+  add  ebp,edx              ; position += step
+  and  ecx,0x00000FFF
+  inc  edi
+  mov  al,[esi+ecx]         ; get source pixel
+  mov  al,[eax]             ; translate color
+  dec  ebx
+  mov  [edi-1],al
+  jnz  short .loop
+
+  mov  ebx,[curx]
+  mov  ecx,[frac]
+  inc  ebx
+  add  ecx,[_ds_step]
+  mov  [curx],ebx
+  mov  [frac],ecx
+  cmp  ebx,[endplane]
+  jb   .plane
+
+.done:
+  popad
+  ret
+; R_DrawSpan486 ends
+
+; ===========================================================================
+; R_DrawSpanPentium
+; horizontal texture mapping, full detail
+; One plane at a time with the R_DrawSpanPentium_13h
+; inner loop: two pixels per iteration, no shld and
+; no patched immediates
+; ===========================================================================
+CODE_SYM_DEF R_DrawSpanPentium
+  pushad
+
+  mov  eax,[_ds_y]
+  mov  ebx,[_ds_x1]
+  lea  edi,[eax+eax*4]
+  mov  ecx,[_ds_frac]
+  shl  edi,4
+  mov  [curx],ebx
+  add  edi,[_destview]
+  add  ebx,4
+  mov  [frac],ecx
+  mov  [dest],edi           ; start of the row
+  mov  [endplane],ebx
+
+.plane:
+  mov  ebx,[curx]
+  mov  ebp,[_ds_x2]
+  mov  cl,bl
+  sub  ebp,ebx
+  js   .done
+  mov  eax,1
+  and  cl,3
+  mov  edx,SC_INDEX+1
+  shl  eax,cl
+  out  dx,al
+  shr  ebx,2
+  mov  edi,[dest]
+  shr  ebp,2
+  add  edi,ebx              ; first pixel in this plane
+  add  ebp,edi              ; last pixel in this plane
+  mov  ecx,[frac]
+  mov  edx,[_ds_step]
+  mov  [spanend],ebp
+  shl  edx,2                ; four pixels apart in the plane
+  mov  esi,[_ds_source]
+  mov  eax,[_ds_colormap]
+  cmp  edi,ebp
+  jae  short .last
+
+.loop:
+  mov  ebx,ecx
+  mov  ebp,ecx
+  shr  ebx,26               ; x units
+  and  ebp,0xFC00           ; y units
+  shr  ebp,4
+  add  ecx,edx              ; position += step
+  or   ebx,ebp
+  mov  ebp,ecx
+  mov  al,[esi+ebx]         ; get first source pixel
+  mov  ebx,ecx
+  shr  ebx,26
+  and  ebp,0xFC00
+  shr  ebp,4
+  add  ecx,edx
+  mov  al,[eax]             ; translate color
+  or   ebx,ebp
+  mov  [edi],al             ; write first pixel
+  add  edi,2
+  mov  al,[esi+ebx]         ; get second source pixel
+  mov  al,[eax]
+  mov  [edi-1],al
+  cmp  edi,[spanend]
+  jb   short .loop
+  ja   short .nextplane     ; even count, nothing left
+
+.last:
+  mov  ebx,ecx
+  shr  ebx,26
+  and  ecx,0xFC00
+  shr  ecx,4
+  or   ebx,ecx
+  mov  al,[esi+ebx]
+  mov  al,[eax]
+  mov  [edi],al
+
+.nextplane:
+  mov  ebx,[curx]
+  mov  ecx,[frac]
+  inc  ebx
+  add  ecx,[_ds_step]
+  mov  [curx],ebx
+  mov  [frac],ecx
+  cmp  ebx,[endplane]
+  jb   .plane
+
+.done:
+  popad
+  ret
+; R_DrawSpanPentium ends
+
 
 ; ===========================================================================
 ; R_DrawSpanLow
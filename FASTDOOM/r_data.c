@@ -36,6 +36,8 @@
 
 #include "r_data.h"
 
+#include "p_setup.h"
+
 //
 // Graphics.
 // DOOM graphics for walls and sprites
@@ -135,6 +137,17 @@ byte **texturecomposite;
 int *flattranslation;
 int *texturetranslation;
 
+// flats used by the current level, by flat number
+byte **flatcache;
+
+#if defined(USE_BACKBUFFER)
+// textures and flats already run through mappedcolormap,
+//  textures as 128 byte columns
+lighttable_t *mappedcolormap;
+byte **texturemapped;
+byte **flatmapped;
+#endif
+
 // needed for pre rendering
 fixed_t *spritewidth;
 fixed_t *spriteoffset;
@@ -451,6 +464,10 @@ void R_InitTextures(void)
     texturecompositesize = Z_MallocUnowned(numtextures * 4, PU_STATIC);
     texturewidthmask = Z_MallocUnowned(numtextures * 4, PU_STATIC);
     textureheight = Z_MallocUnowned(numtextures * 4, PU_STATIC);
+#if defined(USE_BACKBUFFER)
+    texturemapped = Z_MallocUnowned(numtextures * 4, PU_STATIC);
+    SetDWords(texturemapped, 0, numtextures);
+#endif
 
     totalwidth = 0;
 
@@ -547,6 +564,14 @@ void R_InitFlats(void)
 
     for (i = 0; i < numflats; i++)
         flattranslation[i] = i;
+
+    flatcache = Z_MallocUnowned(numflats * sizeof(*flatcache), PU_STATIC);
+    SetDWords(flatcache, 0, numflats);
+
+#if defined(USE_BACKBUFFER)
+    flatmapped = Z_MallocUnowned(numflats * sizeof(*flatmapped), PU_STATIC);
+    SetDWords(flatmapped, 0, numflats);
+#endif
 }
 
 //
@@ -653,30 +678,19 @@ short R_TextureNumForName(char *name)
 }
 
 //
-// R_PrecacheLevel
-// Preloads all relevant graphics for the level.
+// R_InitFlatCache
+// Reads the flats the level can show, animation frames
+//  included, into one arena with every flat on its own
+//  page, so planes don't go through the lump cache.
 //
 int flatmemory;
 
-void R_PrecacheLevel(void)
+void R_InitFlatCache(void)
 {
-    char *flatpresent;
-    char *texturepresent;
-    char spritepresent[NUMSPRITES];
-
+    byte *flatpresent;
+    byte *arena;
     int i;
-    int j;
-    int k;
-    int lump;
-
-    texture_t *texture;
-    thinker_t *th;
-    spriteframe_t *sf;
-
-    if (demoplayback && !timingdemo)
-        return;
 
-    // Precache flats.
     flatpresent = alloca(numflats);
     memset(flatpresent, 0, numflats);
 
@@ -686,17 +700,181 @@ void R_PrecacheLevel(void)
         flatpresent[sectors[i].ceilingpic] = 1;
     }
 
+    P_MarkAnimFlats(flatpresent);
+
+    // Sky planes never read the flat
+    flatpresent[skyflatnum] = 0;
+
     flatmemory = 0;
 
+    for (i = 0; i < numflats; i++)
+    {
+        flatcache[i] = NULL;
+
+        // Odd sized flats stay in the lump cache
+        if (flatpresent[i] && lumpinfo[firstflat + i].size == FLATSIZE)
+            flatmemory += FLATSIZE;
+        else
+            flatpresent[i] = 0;
+    }
+
+    if (!flatmemory)
+        return;
+
+    arena = Z_MallocUnowned(flatmemory + FLATSIZE - 1, PU_LEVEL);
+    arena = (byte *)(((int)arena + FLATSIZE - 1) & ~(FLATSIZE - 1));
+
     for (i = 0; i < numflats; i++)
     {
         if (flatpresent[i])
         {
-            lump = firstflat + i;
-            flatmemory += lumpinfo[lump].size;
-            W_CacheLumpNum(lump, PU_CACHE);
+            flatcache[i] = arena;
+            W_ReadLump(firstflat + i, arena);
+            arena += FLATSIZE;
         }
     }
+}
+
+//
+// R_GetFlat
+//
+byte *R_GetFlat(int picnum)
+{
+    int flat = flattranslation[picnum];
+
+    if (flatcache[flat])
+        return flatcache[flat];
+
+    // Not seen at level setup, the plane is drawn before
+    // anything else can be allocated
+    return W_CacheLumpNum(firstflat + flat, PU_CACHE);
+}
+
+#if defined(USE_BACKBUFFER)
+//
+// R_SetMappedColormap
+// Drops the mapped copies made for another colormap.
+//
+void R_SetMappedColormap(lighttable_t *colormap)
+{
+    int i;
+
+    if (colormap == mappedcolormap)
+        return;
+
+    for (i = 0; i < numtextures; i++)
+    {
+        if (texturemapped[i])
+            Z_Free(texturemapped[i]);
+    }
+
+    for (i = 0; i < numflats; i++)
+    {
+        if (flatmapped[i])
+            Z_Free(flatmapped[i]);
+    }
+
+    mappedcolormap = colormap;
+}
+
+//
+// R_GenerateMapped
+// Every column is 128 bytes, as much as the column
+//  drawers can read before they wrap.
+//
+void R_GenerateMapped(int texnum)
+{
+    byte *block;
+    byte *composite;
+    byte *source;
+    int width;
+    int x;
+    int col;
+    int i;
+    short lump;
+
+    width = textures[texnum]->width;
+
+    // Keep the composite around while the columns are read
+    if (texturecompositesize[texnum])
+    {
+        if (!texturecomposite[texnum])
+            R_GenerateComposite(texnum);
+
+        Z_ChangeTag(texturecomposite[texnum], PU_STATIC);
+    }
+
+    block = Z_Malloc((texturewidthmask[texnum] + 1) * 128, PU_STATIC, &texturemapped[texnum]);
+    composite = texturecomposite[texnum];
+
+    for (x = 0; x <= texturewidthmask[texnum]; x++)
+    {
+        // Columns past the width only exist for odd sized textures
+        col = x < width ? x : x % width;
+        lump = texturecolumnlump[texnum][col];
+
+        if (lump > 0)
+            source = (byte *)W_CacheLumpNum(lump, PU_CACHE) + texturecolumnofs[texnum][col];
+        else
+            source = composite + texturecolumnofs[texnum][col];
+
+        for (i = 0; i < 128; i++)
+            block[i] = mappedcolormap[source[i]];
+
+        block += 128;
+    }
+
+    if (composite)
+        Z_ChangeTag(composite, PU_CACHE);
+
+    Z_ChangeTag(texturemapped[texnum], PU_CACHE);
+}
+
+//
+// R_GetMappedFlat
+//
+byte *R_GetMappedFlat(int picnum)
+{
+    int flat = flattranslation[picnum];
+    byte *source;
+    byte *dest;
+    int i;
+
+    if (flatmapped[flat])
+        return flatmapped[flat];
+
+    dest = Z_Malloc(FLATSIZE, PU_STATIC, &flatmapped[flat]);
+    source = R_GetFlat(picnum);
+
+    for (i = 0; i < FLATSIZE; i++)
+        dest[i] = mappedcolormap[source[i]];
+
+    Z_ChangeTag(dest, PU_CACHE);
+
+    return dest;
+}
+#endif
+
+//
+// R_PrecacheLevel
+// Preloads all relevant graphics for the level.
+//
+void R_PrecacheLevel(void)
+{
+    char *texturepresent;
+    char spritepresent[NUMSPRITES];
+
+    int i;
+    int j;
+    int k;
+    int lump;
+
+    texture_t *texture;
+    thinker_t *th;
+    spriteframe_t *sf;
+
+    if (demoplayback && !timingdemo)
+        return;
 
     // Precache textures.
     texturepresent = alloca(numtextures);
@@ -723,7 +901,9 @@ void R_PrecacheLevel(void)
             continue;
 
         // [crispy] precache composite textures
+        P_BeginSubStage();
         R_GenerateComposite(i);
+        P_EndSubStage();
 
         texture = textures[i];
 
@@ -734,6 +914,9 @@ void R_PrecacheLevel(void)
         }
     }
 
+    P_LoadStage("precache textures");
+    P_LoadSubStage("precache composites");
+
     // Precache sprites.
     SetDWords(spritepresent, 0, NUMSPRITES / 4);
 
@@ -758,4 +941,6 @@ void R_PrecacheLevel(void)
             }
         }
     }
+
+    P_LoadStage("precache sprites");
 }
@@ -28,8 +28,21 @@ void R_GenerateComposite(int texnum);
 
 // I/O, setting up the stuff.
 void R_InitData(void);
+void R_InitFlatCache(void);
 void R_PrecacheLevel(void);
 
+// Flat data for a plane, by flat number before translation.
+byte *R_GetFlat(int picnum);
+
+#if defined(USE_BACKBUFFER)
+// Copies run through one fixed colormap, for the unmapped drawers.
+void R_SetMappedColormap(lighttable_t *colormap);
+void R_GenerateMapped(int texnum);
+byte *R_GetMappedFlat(int picnum);
+
+extern byte **texturemapped;
+#endif
+
 // Retrieval.
 // Floor/ceiling opaque texture tiles,
 // lookup by name. For animation?
@@ -44,5 +57,6 @@ extern int *texturewidthmask;
 extern short **texturecolumnlump;
 extern unsigned short **texturecolumnofs;
 extern byte **texturecomposite;
+extern byte **flatcache;
 
 #endif
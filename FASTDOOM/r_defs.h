@@ -86,6 +86,10 @@ typedef struct
     short special;
     short tag;
 
+    // chains of sectors by tag, see P_InitTagLists
+    int firsttag;
+    int nexttag;
+
     // 0 = untraversed, 1,2 = sndlines -1
     byte soundtraversed;
 
@@ -104,14 +108,34 @@ typedef struct
     // list of mobjs in sector
     mobj_t *thinglist;
 
+    // list of mobjs whose bounding box touches the sector
+    struct msecnode_s *touching_thinglist;
+
     // thinker_t for reversable actions
     void *specialdata;
 
     short linecount;
     struct line_s **lines; // [linecount] size
 
+    // heights at the start of the last tic, for interpolation
+    fixed_t oldfloorheight;
+    fixed_t oldceilingheight;
+
 } sector_t;
 
+//
+// A thing touching a sector, linked both in the thing's list of
+// sectors and in the sector's list of things.
+//
+typedef struct msecnode_s
+{
+    sector_t *m_sector;         // a sector the thing touches
+    struct mobj_s *m_thing;     // the thing touching it
+    struct msecnode_s *m_tprev; // prev thing in the sector's list
+    struct msecnode_s *m_tnext; // next thing in the sector's list
+    struct msecnode_s *m_snext; // next sector in the thing's list
+} msecnode_t;
+
 //
 // The SideDef.
 //
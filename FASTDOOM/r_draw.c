@@ -18,6 +18,7 @@
 //	 e.g. inline assembly, different algorithms.
 //
 
+#include <stdio.h>
 #include <conio.h>
 #include "doomdef.h"
 #include "options.h"
@@ -25,6 +26,7 @@
 #include "i_ibm.h"
 #include "z_zone.h"
 #include "w_wad.h"
+#include "ns_task.h"
 
 #include "r_local.h"
 
@@ -3348,4 +3350,92 @@ void R_DrawFuzzColumnSaturn_13h(void)
         }
     }
 }
+//
+// R_DrawBench
+// Times the linear column and span drawers on the
+// backbuffer with fixed inputs. Pentiums count TSC
+// cycles, older CPUs fall back to the PIT.
+//
+#define BENCHFRAMES 16
+#define BENCHPIXELS (BENCHFRAMES * SCREENWIDTH * SCREENHEIGHT)
+
+typedef struct
+{
+    char *name;
+    void (*func)(void);
+    boolean span;
+} benchdrawer_t;
+
+benchdrawer_t benchdrawers[] =
+{
+    {"R_DrawColumn_13h", R_DrawColumn_13h, false},
+    {"R_DrawColumnPentium_13h", R_DrawColumnPentium_13h, false},
+    {"R_DrawSpan_13h", R_DrawSpan_13h, true},
+    {"R_DrawSpanPentium_13h", R_DrawSpanPentium_13h, true},
+    {"R_DrawColumnUnmapped_13h", R_DrawColumnUnmapped_13h, false},
+    {"R_DrawSpanUnmapped_13h", R_DrawSpanUnmapped_13h, true},
+};
+
+void R_DrawBench(void)
+{
+    int i, j, k;
+    unsigned int start, elapsed;
+    byte *source;
+
+    source = Z_MallocUnowned(64 * 64, PU_STATIC);
+    for (i = 0; i < 64 * 64; i++)
+        source[i] = i ^ (i >> 6);
+
+    R_InitBuffer(SCREENWIDTH, SCREENHEIGHT);
+
+    dc_colormap = ds_colormap = colormaps;
+    dc_source = ds_source = source;
+    dc_iscale = FRACUNIT * 3 / 4;
+    dc_texturemid = 0;
+    dc_yl = 0;
+    dc_yh = SCREENHEIGHT - 1;
+    ds_x1 = 0;
+    ds_x2 = SCREENWIDTH - 1;
+    ds_step = 0x00C000C0;
+
+    printf("R_DrawBench: %i frames per drawer, %s\n", BENCHFRAMES, selectedCPU >= cpu_pentium ? "cycles per pixel" : "ns per pixel");
+
+    for (i = 0; i < sizeof(benchdrawers) / sizeof(benchdrawer_t); i++)
+    {
+        start = selectedCPU >= cpu_pentium ? I_ReadTSC() : TS_GetClock();
+
+        for (j = 0; j < BENCHFRAMES; j++)
+        {
+            if (benchdrawers[i].span)
+            {
+                for (k = 0; k < SCREENHEIGHT; k++)
+                {
+                    ds_y = k;
+                    ds_frac = k << 10;
+                    benchdrawers[i].func();
+                }
+            }
+            else
+            {
+                for (k = 0; k < SCREENWIDTH; k++)
+                {
+                    dc_x = k;
+                    benchdrawers[i].func();
+                }
+            }
+        }
+
+        // Hundredths per pixel, a PIT clock is 838 ns
+        if (selectedCPU >= cpu_pentium)
+            elapsed = (I_ReadTSC() - start) / (BENCHPIXELS / 100);
+        else
+            elapsed = (TS_GetClock() - start) * 838 / (BENCHPIXELS / 100);
+
+        printf("%-24s %3i.%02i\n", benchdrawers[i].name, elapsed / 100, elapsed % 100);
+    }
+
+    Z_Free(source);
+
+    I_Error("R_DrawBench: done");
+}
 #endif
@@ -22,6 +22,7 @@
 #define __R_DRAW__
 
 #define FLATPIXELCOLOR 1850
+#define FLATSIZE 4096
 
 extern lighttable_t *dc_colormap;
 extern int dc_x;
@@ -47,6 +48,8 @@ extern byte **ylookup;
 //  here.
 
 void R_DrawColumn(void);
+void R_DrawColumn486(void);
+void R_DrawColumnPentium(void);
 void R_DrawSkyFlat(void);
 void R_DrawColumnLow(void);
 void R_DrawSkyFlatLow(void);
@@ -109,7 +112,11 @@ void R_DrawFuzzColumnFastText4050(void);
 void R_DrawFuzzColumnSaturnText4050(void);
 
 void R_DrawColumn_13h(void);
+void R_DrawColumnPentium_13h(void);
 void R_DrawSpan_13h(void);
+void R_DrawSpanPentium_13h(void);
+void R_DrawColumnUnmapped_13h(void);
+void R_DrawSpanUnmapped_13h(void);
 void R_DrawFuzzColumn_13h(void);
 void R_DrawFuzzColumnFast_13h(void);
 void R_DrawSkyFlat_13h(void);
@@ -125,6 +132,10 @@ void R_DrawFuzzColumnVBE2(void);
 
 void R_VideoErase(unsigned ofs, int count);
 
+#if defined(USE_BACKBUFFER)
+void R_DrawBench(void);
+#endif
+
 extern int ds_y;
 extern int ds_x1;
 extern int ds_x2;
@@ -140,6 +151,8 @@ extern byte *ds_source;
 // Span blitting for rows, floor/ceiling.
 // No Sepctre effect needed.
 void R_DrawSpan(void);
+void R_DrawSpan486(void);
+void R_DrawSpanPentium(void);
 void R_DrawSpanFlat(void);
 
 // Low resolution mode, 160x200?
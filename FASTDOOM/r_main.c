@@ -26,11 +26,16 @@
 #include "doomdef.h"
 #include "doomstat.h"
 #include "d_net.h"
+#include "i_system.h"
+
+#include "z_zone.h"
 
 #include "m_misc.h"
 
 #include "r_local.h"
 #include "r_sky.h"
+#include "i_ibm.h"
+#include "p_tick.h"
 
 #include "std_func.h"
 
@@ -102,6 +107,9 @@ void (*basecolfunc)(void);
 void (*fuzzcolfunc)(void);
 void (*spanfunc)(void);
 void (*skyfunc)(void);
+#if defined(USE_BACKBUFFER)
+void (*basespanfunc)(void);
+#endif
 
 byte R_PointOnSegSide(fixed_t x,
                       fixed_t y,
@@ -886,17 +894,26 @@ void R_ExecuteSetViewSize(void)
     switch (detailshift)
     {
     case 0:
-        colfunc = basecolfunc = R_DrawColumn;
+        if (selectedCPU >= cpu_pentium)
+            colfunc = basecolfunc = R_DrawColumnPentium;
+        else if (selectedCPU == cpu_486)
+            colfunc = basecolfunc = R_DrawColumn486;
+        else
+            colfunc = basecolfunc = R_DrawColumn;
 
         if (untexturedSurfaces)
             spanfunc = R_DrawSpanFlat;
+        else if (selectedCPU >= cpu_pentium)
+            spanfunc = R_DrawSpanPentium;
+        else if (selectedCPU == cpu_486)
+            spanfunc = R_DrawSpan486;
         else
             spanfunc = R_DrawSpan;
 
         if (flatSky)
             skyfunc = R_DrawSkyFlat;
         else
-            skyfunc = R_DrawColumn;
+            skyfunc = basecolfunc;
 
         if (flatShadows)
             fuzzcolfunc = R_DrawFuzzColumnFast;
@@ -948,17 +965,22 @@ void R_ExecuteSetViewSize(void)
     }
 #endif
 #if defined(USE_BACKBUFFER)
-    colfunc = basecolfunc = R_DrawColumn_13h;
+    if (selectedCPU >= cpu_pentium)
+        colfunc = basecolfunc = R_DrawColumnPentium_13h;
+    else
+        colfunc = basecolfunc = R_DrawColumn_13h;
 
     if (untexturedSurfaces)
-        spanfunc = R_DrawSpanFlat_13h;
+        spanfunc = basespanfunc = R_DrawSpanFlat_13h;
+    else if (selectedCPU >= cpu_pentium)
+        spanfunc = basespanfunc = R_DrawSpanPentium_13h;
     else
-        spanfunc = R_DrawSpan_13h;
+        spanfunc = basespanfunc = R_DrawSpan_13h;
 
     if (flatSky)
         skyfunc = R_DrawSkyFlat_13h;
     else
-        skyfunc = R_DrawColumn_13h;
+        skyfunc = basecolfunc;
 
     if (flatShadows)
         fuzzcolfunc = R_DrawFuzzColumnFast_13h;
@@ -1149,6 +1171,83 @@ R_PointInSubsector(fixed_t x,
     return &subsectors[nodenum & ~NF_SUBSECTOR];
 }
 
+//
+// Frame interpolation
+// With -uncapped, frames drawn between tics place the view,
+// the things and the moving sectors between where the last
+// tic started and where it left them.
+//
+fixed_t interpfrac = FRACUNIT;
+
+typedef struct
+{
+    sector_t *sector;
+    fixed_t floorheight;
+    fixed_t ceilingheight;
+} interpsector_t;
+
+interpsector_t *interpsectors; // [numsectors], real heights while drawing
+int numinterpsectors;
+
+//
+// R_InitInterpolation
+// Called by P_SetupLevel, any sector can move during a tic.
+//
+void R_InitInterpolation(void)
+{
+    interpsectors = Z_MallocUnowned(numsectors * sizeof(interpsector_t), PU_LEVEL);
+    numinterpsectors = 0;
+}
+
+//
+// R_InterpolateSectors
+// Moves the sectors that changed height in the last tic,
+// R_RestoreSectors puts the real heights back before the
+// game runs again.
+//
+void R_InterpolateSectors(void)
+{
+    int i;
+    sector_t *sec;
+    interpsector_t *interp;
+
+    numinterpsectors = 0;
+
+    if (interpfrac == FRACUNIT)
+        return;
+
+    interp = interpsectors;
+
+    for (i = 0, sec = sectors; i < numsectors; i++, sec++)
+    {
+        if (sec->floorheight == sec->oldfloorheight && sec->ceilingheight == sec->oldceilingheight)
+            continue;
+
+        interp->sector = sec;
+        interp->floorheight = sec->floorheight;
+        interp->ceilingheight = sec->ceilingheight;
+        interp++;
+
+        sec->floorheight = sec->oldfloorheight + FixedMul(sec->floorheight - sec->oldfloorheight, interpfrac);
+        sec->ceilingheight = sec->oldceilingheight + FixedMul(sec->ceilingheight - sec->oldceilingheight, interpfrac);
+    }
+
+    numinterpsectors = interp - interpsectors;
+}
+
+void R_RestoreSectors(void)
+{
+    int i;
+
+    for (i = 0; i < numinterpsectors; i++)
+    {
+        interpsectors[i].sector->floorheight = interpsectors[i].floorheight;
+        interpsectors[i].sector->ceilingheight = interpsectors[i].ceilingheight;
+    }
+
+    numinterpsectors = 0;
+}
+
 //
 // R_SetupFrame
 //
@@ -1156,16 +1255,32 @@ void R_SetupFrame(void)
 {
     int i;
 
-    viewx = (players_mo)->x;
+    // Only between two tics that both ran the game
+    if (uncappedFPS && !singletics && interptic == gametic - 1)
+        interpfrac = I_GetTicFrac();
+    else
+        interpfrac = FRACUNIT;
+
+    if (interpfrac != FRACUNIT)
+    {
+        viewx = players_mo->oldx + FixedMul(players_mo->x - players_mo->oldx, interpfrac);
+        viewy = players_mo->oldy + FixedMul(players_mo->y - players_mo->oldy, interpfrac);
+        viewangle = players_mo->oldangle + FixedMul((int)(players_mo->angle - players_mo->oldangle), interpfrac);
+        viewz = players.oldviewz + FixedMul(players.viewz - players.oldviewz, interpfrac);
+    }
+    else
+    {
+        viewx = players_mo->x;
+        viewy = players_mo->y;
+        viewangle = players_mo->angle;
+        viewz = players.viewz;
+    }
+
     viewxs = viewx >> FRACBITS;
-    viewy = (players_mo)->y;
     viewyneg = -viewy;
     viewys = viewy >> FRACBITS;
-    viewangle = (players_mo)->angle;
     extralight = players.extralight;
 
-    viewz = players.viewz;
-
     viewsin = finesine[viewangle >> ANGLETOFINESHIFT];
     viewcos = finecosine[viewangle >> ANGLETOFINESHIFT];
 
@@ -1181,6 +1296,24 @@ void R_SetupFrame(void)
     else
         fixedcolormap = 0;
 
+#if defined(USE_BACKBUFFER)
+    // Walls and textured planes read copies already run through
+    // the fixed colormap, so their drawers skip the lookup
+    if (fixedcolormap)
+    {
+        R_SetMappedColormap(fixedcolormap);
+        colfunc = R_DrawColumnUnmapped_13h;
+
+        if (!untexturedSurfaces)
+            spanfunc = R_DrawSpanUnmapped_13h;
+    }
+    else
+    {
+        colfunc = basecolfunc;
+        spanfunc = basespanfunc;
+    }
+#endif
+
     validcount++;
     
     #ifdef MODE_VBE2_DIRECT
@@ -1198,6 +1331,7 @@ void R_SetupFrame(void)
 void R_RenderPlayerView(void)
 {
     R_SetupFrame();
+    R_InterpolateSectors();
 
     // Clear buffers.
     R_ClearClipSegs();
@@ -1290,8 +1424,15 @@ void R_RenderPlayerView(void)
     // Check for new console commands.
     NetUpdate();
 
+#if defined(USE_BACKBUFFER)
+    // Masked walls and sprites still translate every pixel
+    colfunc = basecolfunc;
+#endif
+
     R_DrawMasked();
 
+    R_RestoreSectors();
+
     // Check for new console commands.
     NetUpdate();
 }
@@ -91,6 +91,13 @@ extern void (*fuzzcolfunc)(void);
 extern void (*spanfunc)(void);
 extern void (*skyfunc)(void);
 
+// FRACUNIT unless the frame falls between two tics
+extern fixed_t interpfrac;
+void R_InitInterpolation(void);
+#if defined(USE_BACKBUFFER)
+extern void (*basespanfunc)(void);
+#endif
+
 //
 // Utility functions.
 byte R_PointOnSegSide(fixed_t x,
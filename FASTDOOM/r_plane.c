@@ -351,7 +351,12 @@ void R_DrawPlanes(void)
 
         // regular flat
 
-        ds_source = W_CacheLumpNum(firstflat + flattranslation[pl->picnum], PU_STATIC);
+#if defined(USE_BACKBUFFER)
+        if (spanfunc == R_DrawSpanUnmapped_13h)
+            ds_source = R_GetMappedFlat(pl->picnum);
+        else
+#endif
+            ds_source = R_GetFlat(pl->picnum);
         planeheight = abs(pl->height - viewz);
         light = (pl->lightlevel >> LIGHTSEGSHIFT) + extralight;
 
@@ -398,8 +403,6 @@ void R_DrawPlanes(void)
                 b2--;
             }
         }
-
-        Z_ChangeTag(ds_source, PU_CACHE);
     }
 }
 
@@ -428,7 +431,7 @@ void R_DrawPlanesFlatSurfaces(void)
             continue;
         }
 
-        dc_source = W_CacheLumpNum(firstflat + flattranslation[pl->picnum], PU_STATIC);
+        dc_source = R_GetFlat(pl->picnum);
 
         color = colormaps[dc_source[FLATPIXELCOLOR]];
 
@@ -586,8 +589,6 @@ void R_DrawPlanesFlatSurfaces(void)
 
             x += 4;
         } while (x <= pl->maxx);
-
-        Z_ChangeTag(dc_source, PU_CACHE);
     }
 }
 
@@ -612,7 +613,7 @@ void R_DrawPlanesFlatSurfacesLow(void)
             continue;
         }
 
-        dc_source = W_CacheLumpNum(firstflat + flattranslation[pl->picnum], PU_STATIC);
+        dc_source = R_GetFlat(pl->picnum);
 
         color = colormaps[dc_source[FLATPIXELCOLOR]];
         // Plane 0
@@ -690,8 +691,6 @@ void R_DrawPlanesFlatSurfacesLow(void)
 
             x += 2;
         } while (x <= pl->maxx);
-
-        Z_ChangeTag(dc_source, PU_CACHE);
     }
 }
 
@@ -716,7 +715,7 @@ void R_DrawPlanesFlatSurfacesPotato(void)
             continue;
         }
 
-        dc_source = W_CacheLumpNum(firstflat + flattranslation[pl->picnum], PU_STATIC);
+        dc_source = R_GetFlat(pl->picnum);
 
         color = colormaps[dc_source[FLATPIXELCOLOR]];
 
@@ -746,8 +745,6 @@ void R_DrawPlanesFlatSurfacesPotato(void)
                 count--;
             };
         }
-
-        Z_ChangeTag(dc_source, PU_CACHE);
     }
 }
 
@@ -777,7 +774,7 @@ void R_DrawPlanesFlatSurfacesText80100(void)
             continue;
         }
 
-        dc_source = W_CacheLumpNum(firstflat + flattranslation[pl->picnum], PU_STATIC);
+        dc_source = R_GetFlat(pl->picnum);
 
         color = colormaps[dc_source[FLATPIXELCOLOR]];
         colorblock = color << 8 | 219;
@@ -831,8 +828,6 @@ void R_DrawPlanesFlatSurfacesText80100(void)
                 *dest = vmem | color << 8 | 223;
             }
         }
-
-        Z_ChangeTag(dc_source, PU_CACHE);
     }
 }
 #endif
@@ -859,7 +854,7 @@ void R_DrawPlanesFlatSurfacesText8050(void)
             continue;
         }
 
-        dc_source = W_CacheLumpNum(firstflat + flattranslation[pl->picnum], PU_STATIC);
+        dc_source = R_GetFlat(pl->picnum);
         color = colormaps[dc_source[FLATPIXELCOLOR]] << 8 | 219;
 
         for (x = pl->minx; x <= pl->maxx; x++)
@@ -887,8 +882,6 @@ void R_DrawPlanesFlatSurfacesText8050(void)
                 count--;
             };
         }
-
-        Z_ChangeTag(dc_source, PU_CACHE);
     }
 }
 #endif
@@ -919,7 +912,7 @@ void R_DrawPlanesFlatSurfacesText4050(void)
             continue;
         }
 
-        dc_source = W_CacheLumpNum(firstflat + flattranslation[pl->picnum], PU_STATIC);
+        dc_source = R_GetFlat(pl->picnum);
 
         color = colormaps[dc_source[FLATPIXELCOLOR]];
         colorblock = color << 8 | 219;
@@ -973,8 +966,6 @@ void R_DrawPlanesFlatSurfacesText4050(void)
                 *dest = vmem | color << 8 | 223;
             }
         }
-
-        Z_ChangeTag(dc_source, PU_CACHE);
     }
 }
 #endif
@@ -1001,7 +992,7 @@ void R_DrawPlanesFlatSurfacesText4025(void)
             continue;
         }
 
-        dc_source = W_CacheLumpNum(firstflat + flattranslation[pl->picnum], PU_STATIC);
+        dc_source = R_GetFlat(pl->picnum);
         color = colormaps[dc_source[FLATPIXELCOLOR]] << 8 | 219;
 
         for (x = pl->minx; x <= pl->maxx; x++)
@@ -1029,8 +1020,6 @@ void R_DrawPlanesFlatSurfacesText4025(void)
                 count--;
             };
         }
-
-        Z_ChangeTag(dc_source, PU_CACHE);
     }
 }
 #endif
@@ -1060,7 +1049,7 @@ void R_DrawPlanesFlatSurfacesTextMDA(void)
             continue;
         }
 
-        dc_source = W_CacheLumpNum(firstflat + flattranslation[pl->picnum], PU_STATIC);
+        dc_source = R_GetFlat(pl->picnum);
 
         color = colormaps[dc_source[FLATPIXELCOLOR]];
         colorblock = 0x0F << 8 | color;
@@ -1108,8 +1097,6 @@ void R_DrawPlanesFlatSurfacesTextMDA(void)
                 *dest = 0x0F << 8 | 0xDB;
             }
         }
-
-        Z_ChangeTag(dc_source, PU_CACHE);
     }
 }
 #endif
@@ -1140,7 +1127,7 @@ void R_DrawPlanesFlatSurfacesText8025(void)
             continue;
         }
 
-        dc_source = W_CacheLumpNum(firstflat + flattranslation[pl->picnum], PU_STATIC);
+        dc_source = R_GetFlat(pl->picnum);
 
         color = colormaps[dc_source[FLATPIXELCOLOR]];
         colorblock = color << 8 | 219;
@@ -1194,8 +1181,6 @@ void R_DrawPlanesFlatSurfacesText8025(void)
                 *dest = vmem | color << 8 | 223;
             }
         }
-
-        Z_ChangeTag(dc_source, PU_CACHE);
     }
 }
 #endif
@@ -1222,7 +1207,7 @@ void R_DrawPlanesFlatSurfaces_13h(void)
             continue;
         }
 
-        dc_source = W_CacheLumpNum(firstflat + flattranslation[pl->picnum], PU_STATIC);
+        dc_source = R_GetFlat(pl->picnum);
 
         color = colormaps[dc_source[FLATPIXELCOLOR]];
 
@@ -1252,8 +1237,6 @@ void R_DrawPlanesFlatSurfaces_13h(void)
                 dest += SCREENWIDTH;
             } while (count--);
         }
-
-        Z_ChangeTag(dc_source, PU_CACHE);
     }
 }
 #endif
@@ -1280,7 +1263,7 @@ void R_DrawPlanesFlatSurfacesVBE2(void)
             continue;
         }
 
-        dc_source = W_CacheLumpNum(firstflat + flattranslation[pl->picnum], PU_STATIC);
+        dc_source = R_GetFlat(pl->picnum);
 
         color = colormaps[dc_source[FLATPIXELCOLOR]];
 
@@ -1298,8 +1281,6 @@ void R_DrawPlanesFlatSurfacesVBE2(void)
                 dest += SCREENWIDTH;
             } while (count--);
         }
-
-        Z_ChangeTag(dc_source, PU_CACHE);
     }
 }
 #endif
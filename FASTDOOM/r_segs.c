@@ -34,6 +34,7 @@
 #include <conio.h>
 
 #include "sizeopt.h"
+#include "am_map.h"
 
 #define SC_INDEX 0x3C4
 
@@ -401,6 +402,16 @@ void R_RenderSegLoop(void)
 				lump = texturecolumnlump[tex][col];
 				ofs = texturecolumnofs[tex][col];
 
+#if defined(USE_BACKBUFFER)
+				if (fixedcolormap)
+				{
+					if (!texturemapped[tex])
+						R_GenerateMapped(tex);
+
+					dc_source = texturemapped[tex] + (col << 7);
+				}
+				else
+#endif
 				if (lump > 0)
 				{
 					dc_source = (byte *)W_CacheLumpNum(lump, PU_CACHE) + ofs;
@@ -463,6 +474,16 @@ void R_RenderSegLoop(void)
 					lump = texturecolumnlump[tex][col];
 					ofs = texturecolumnofs[tex][col];
 
+#if defined(USE_BACKBUFFER)
+					if (fixedcolormap)
+					{
+						if (!texturemapped[tex])
+							R_GenerateMapped(tex);
+
+						dc_source = texturemapped[tex] + (col << 7);
+					}
+					else
+#endif
 					if (lump > 0)
 					{
 						dc_source = (byte *)W_CacheLumpNum(lump, PU_CACHE) + ofs;
@@ -529,6 +550,16 @@ void R_RenderSegLoop(void)
 					lump = texturecolumnlump[tex][col];
 					ofs = texturecolumnofs[tex][col];
 
+#if defined(USE_BACKBUFFER)
+					if (fixedcolormap)
+					{
+						if (!texturemapped[tex])
+							R_GenerateMapped(tex);
+
+						dc_source = texturemapped[tex] + (col << 7);
+					}
+					else
+#endif
 					if (lump > 0)
 					{
 						dc_source = (byte *)W_CacheLumpNum(lump, PU_CACHE) + ofs;
@@ -607,7 +638,8 @@ void R_StoreWallRange(int start,
 	linedef = curline->linedef;
 
 	// mark the segment as visible for auto map
-	linedef->flags |= ML_MAPPED;
+	if (!(linedef->flags & ML_MAPPED))
+		AM_MapLine(linedef);
 
 	// calculate rw_distance for scale calculation
 	rw_normalangle = curline->angle + ANG90;
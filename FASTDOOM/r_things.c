@@ -138,6 +138,11 @@ void R_InstallSpriteLump(int lump,
 //  letter/number appended.
 // The rotation character can be 0 to signify no rotations.
 //
+// Sprite lumps are bucketed by their 4 character prefix
+//  in a single pass, so each name only walks its own chain.
+#define SPRITEHASHSIZE 256
+#define SPRITEHASH(n) ((((n) >> 16) ^ (n)) * 31 >> 8 & (SPRITEHASHSIZE - 1))
+
 void R_InitSpriteDefs(char const **namelist)
 {
     int i;
@@ -147,37 +152,53 @@ void R_InitSpriteDefs(char const **namelist)
     int rotation;
     int start;
     int end;
-    int patched;
+    int *spritehash;
+    int *spritenext;
+    int *spritelump;
 
     start = firstspritelump - 1;
     end = lastspritelump + 1;
 
-    // scan all the lump names for each of the names,
+    spritehash = Z_MallocUnowned(SPRITEHASHSIZE * sizeof(int), PU_STATIC);
+    spritenext = Z_MallocUnowned((end - start) * sizeof(int), PU_STATIC);
+    spritelump = Z_MallocUnowned((end - start) * sizeof(int), PU_STATIC);
+    SetDWords(spritehash, -1, SPRITEHASHSIZE);
+
+    // link from the back, so every chain stays in lump order
+    //  and later lumps still override earlier ones
+    for (l = end - 1; l > start; l--)
+    {
+        intname = SPRITEHASH(*(int *)lumpinfo[l].name);
+        spritenext[l - start] = spritehash[intname];
+        spritehash[intname] = l;
+
+        // resolve PWAD replacements once, not on every match
+        if (modifiedgame)
+            spritelump[l - start] = W_GetNumForName(lumpinfo[l].name);
+        else
+            spritelump[l - start] = l;
+    }
+
+    // walk the chain for each of the names,
     //  noting the highest frame letter.
     // Just compare 4 characters as ints
     for (i = 0; i < NUMSPRITES; i++)
     {
-        char const *spritename = namelist[i];
         SetBytes(sprtemp, -1, sizeof(sprtemp));
 
         maxframe = -1;
         intname = *(int *)namelist[i];
 
-        // scan the lumps,
+        // scan the bucket,
         //  filling in the frames for whatever is found
-        for (l = start + 1; l < end; l++)
+        for (l = spritehash[SPRITEHASH(intname)]; l != -1; l = spritenext[l - start])
         {
             if (*(int *)lumpinfo[l].name == intname)
             {
                 frame = lumpinfo[l].name[4] - 'A';
                 rotation = lumpinfo[l].name[5] - '0';
 
-                if (modifiedgame)
-                    patched = W_GetNumForName(lumpinfo[l].name);
-                else
-                    patched = l;
-
-                R_InstallSpriteLump(patched, frame, rotation, 0);
+                R_InstallSpriteLump(spritelump[l - start], frame, rotation, 0);
 
                 if (lumpinfo[l].name[6])
                 {
@@ -203,6 +224,10 @@ void R_InitSpriteDefs(char const **namelist)
         CopyBytes(sprtemp, sprites[i].spriteframes, maxframe * sizeof(spriteframe_t));
         //memcpy(sprites[i].spriteframes, sprtemp, maxframe * sizeof(spriteframe_t));
     }
+
+    Z_Free(spritelump);
+    Z_Free(spritenext);
+    Z_Free(spritehash);
 }
 
 //
@@ -395,9 +420,27 @@ void R_ProjectSprite(mobj_t *thing)
     angle_t ang;
     fixed_t iscale;
 
+    fixed_t gx;
+    fixed_t gy;
+    fixed_t gz;
+
+    // between tics, draw it between its last two positions
+    if (interpfrac != FRACUNIT)
+    {
+        gx = thing->oldx + FixedMul(thing->x - thing->oldx, interpfrac);
+        gy = thing->oldy + FixedMul(thing->y - thing->oldy, interpfrac);
+        gz = thing->oldz + FixedMul(thing->z - thing->oldz, interpfrac);
+    }
+    else
+    {
+        gx = thing->x;
+        gy = thing->y;
+        gz = thing->z;
+    }
+
     // transform the origin point
-    tr_x = thing->x - viewx;
-    tr_y = thing->y - viewy;
+    tr_x = gx - viewx;
+    tr_y = gy - viewy;
 
     if (nearSprites && !(thing->flags & MF_SHOOTABLE) && (abs(tr_x) > 40000000 || abs(tr_y) > 40000000))
         return;
@@ -423,7 +466,7 @@ void R_ProjectSprite(mobj_t *thing)
     if (sprframe->rotate)
     {
         // choose a different rotation based on player view
-        ang = R_PointToAngle(thing->x, thing->y);
+        ang = R_PointToAngle(gx, gy);
         rot = (ang - thing->angle + (unsigned)(ANG45 / 2) * 9) >> 29;
         lump = sprframe->lump[rot];
         flip = sprframe->flip[rot];
@@ -459,10 +502,10 @@ void R_ProjectSprite(mobj_t *thing)
     // killough 4/9/98: clip things which are out of view due to height
     // viti95 6/6/20: optimize by removing divisions and using multiplications instead. Also discard first than calculate other things.
 
-    if (FixedMul(thing->z - viewz, xscale) > viewheightshift)
+    if (FixedMul(gz - viewz, xscale) > viewheightshift)
         return;
 
-    gzt = thing->z + spritetopoffset[lump];
+    gzt = gz + spritetopoffset[lump];
 
     if (viewheightopt < FixedMul(viewz - gzt, xscale))
         return;
@@ -501,9 +544,9 @@ void R_ProjectSprite(mobj_t *thing)
     vis->scale = xscale;
 #endif
 
-    vis->gx = thing->x;
-    vis->gy = thing->y;
-    vis->gz = thing->z;
+    vis->gx = gx;
+    vis->gy = gy;
+    vis->gz = gz;
     vis->gzt = gzt; // killough 3/27/98
     vis->texturemid = gzt - viewz;
     vis->x1 = x1 < 0 ? 0 : x1;
@@ -155,8 +155,9 @@ void S_StopChannel(int cnum)
 
     int i;
     channel_t *c = &channels[cnum];
+    sfxinfo_t *sfx = c->sfxinfo;
 
-    if (c->sfxinfo)
+    if (sfx)
     {
         // stop the sound playing
         if (SFX_Playing(c->handle))
@@ -164,6 +165,17 @@ void S_StopChannel(int cnum)
             SFX_StopPatch(c->handle);
         }
         c->sfxinfo = 0;
+
+        // the resampled copy can go once no channel plays it
+        if (sfx->resampled)
+        {
+            for (i = 0; i < numChannels; i++)
+                if (channels[i].sfxinfo == sfx)
+                    break;
+
+            if (i == numChannels)
+                Z_ChangeTag(sfx->resampled, PU_CACHE);
+        }
     }
 }
 
@@ -387,9 +399,18 @@ void S_StartSound(mobj_t *origin, byte sfx_id)
         sfx->data = (void *)W_CacheLumpNum(sfx->lumpnum, PU_SOUND);
     }
 
+    if (!sfx->resampled)
+        SFX_Resample(sfx->data, &sfx->resampled);
+
     // Assigns the handle to one of the channels in the
     //  mix/output buffer.
-    channels[cnum].handle = SFX_PlayPatch(sfx->data, sep, volume);
+    if (sfx->resampled)
+    {
+        Z_ChangeTag(sfx->resampled, PU_SOUND);
+        channels[cnum].handle = SFX_PlayPatch(sfx->resampled, sep, volume);
+    }
+    else
+        channels[cnum].handle = SFX_PlayPatch(sfx->data, sep, volume);
 }
 
 //
@@ -401,6 +422,8 @@ void S_UpdateSounds(void)
     int volume;
     int sep;
 
+    I_UpdateSound();
+
     if (snd_SfxDevice == snd_none)
         return;
 
@@ -41,6 +41,9 @@ struct sfxinfo_struct
 
     // lump number of sfx
     int lumpnum;
+
+    // copy at the mixer rate, purgeable
+    void *resampled;
 };
 
 //
@@ -23,6 +23,7 @@
 #include "v_video.h"
 
 #include "i_system.h"
+#include "i_ibm.h"
 
 #include "w_wad.h"
 
@@ -95,14 +96,14 @@ void STlib_drawNum(st_number_t *n, byte refresh)
         return;
     }
 
-#if defined(USE_BACKBUFFER)
-    updatestate |= I_STATBAR;
-#endif
-
     w = n->p[0]->width;
     h = n->p[0]->height;
     x = n->x;
 
+#if defined(USE_BACKBUFFER)
+    I_DirtyStatBar(n->x - 3 * w, n->y, 3 * w, h);
+#endif
+
     n->oldnum = *n->num;
 
     // clear the area
@@ -238,6 +239,7 @@ void STlib_updatePercent(st_percent_t *per, int refresh)
 #endif
 #if defined(USE_BACKBUFFER)
         V_DrawPatchDirect(per->n.x, per->n.y, per->p);
+        I_DirtyStatBar(per->n.x - per->p->leftoffset, per->n.y - per->p->topoffset, per->p->width, per->p->height);
 #endif
     }
 
@@ -320,11 +322,12 @@ void STlib_updateMultIcon(st_multicon_t *mi, byte refresh)
 #if defined(USE_BACKBUFFER)
         V_DrawPatchDirect(mi->x, mi->y, mi->p[*mi->inum]);
 #endif
-        mi->oldinum = *mi->inum;
-
 #if defined(USE_BACKBUFFER)
-        updatestate |= I_STATBAR;
+        if (mi->oldinum != -1)
+            I_DirtyStatBar(x, y, w, h);
+        I_DirtyStatBar(mi->x - mi->p[*mi->inum]->leftoffset, mi->y - mi->p[*mi->inum]->topoffset, mi->p[*mi->inum]->width, mi->p[*mi->inum]->height);
 #endif
+        mi->oldinum = *mi->inum;
     }
 }
 #endif
@@ -366,7 +369,10 @@ void STlib_updateBinIcon(st_binicon_t *bi, byte refresh)
         }
 
 #if defined(USE_BACKBUFFER)
-        updatestate |= I_STATBAR;
+        if (simpleStatusBar)
+            I_DirtyStatBar(bi->x, bi->y, 40, 30);
+        else
+            I_DirtyStatBar(bi->x - bi->p->leftoffset, bi->y - bi->p->topoffset, bi->p->width, bi->p->height);
 #endif
     }
 }
@@ -23,6 +23,7 @@
 #include "i_random.h"
 
 #include "i_system.h"
+#include "i_ibm.h"
 #include "z_zone.h"
 #include "m_misc.h"
 #include "w_wad.h"
@@ -427,7 +428,7 @@ void ST_refreshBackground(void)
 		}
 
 #if defined(USE_BACKBUFFER)
-		updatestate |= I_STATBAR;
+		I_DirtyStatBar(ST_X, ST_Y, ST_WIDTH, ST_HEIGHT);
 #endif
 	}
 }
@@ -236,6 +236,9 @@ short W_GetNumForName(char *name)
     return -1;
 }
 
+int lumpreads;
+int lumpreadbytes;
+
 //
 // W_ReadLump
 // Loads the lump into the given buffer,
@@ -261,6 +264,9 @@ void W_ReadLump(int lump,
     lseek(handle, l->position, SEEK_SET);
     c = read(handle, dest, l->size);
 
+    lumpreads++;
+    lumpreadbytes += l->size;
+
     if (l->handle == -1)
         close(handle);
 }
@@ -64,6 +64,10 @@ short W_GetNumForName(char *name);
 
 void W_ReadLump(int lump, void *dest);
 
+// Disk activity through W_ReadLump.
+extern int lumpreads;
+extern int lumpreadbytes;
+
 void *W_CacheLumpNum(int lump, byte tag);
 
 #define W_CacheLumpName(name, tag) W_CacheLumpNum(W_GetNumForName((name)), (tag))
@@ -75,6 +75,8 @@ void Z_Init(void)
     block->size = mainzone->size - sizeof(memzone_t);
 }
 
+int zonepurges;
+
 //
 // Z_Free
 //
@@ -177,6 +179,7 @@ void *Z_Malloc(int size, byte tag, void *user)
                 // the rover can be the base block
                 base = base->prev;
                 Z_Free((byte *)rover + sizeof(memblock_t));
+                zonepurges++;
                 base = base->next;
                 rover = base->next;
             }
@@ -261,6 +264,7 @@ void *Z_MallocUnowned(int size, byte tag)
                 // the rover can be the base block
                 base = base->prev;
                 Z_Free((byte *)rover + sizeof(memblock_t));
+                zonepurges++;
                 base = base->next;
                 rover = base->next;
             }
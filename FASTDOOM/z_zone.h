@@ -44,6 +44,9 @@ void *Z_MallocUnowned(int size, byte tag);
 void Z_Free(void *ptr);
 void Z_FreeTags(byte lowtag, byte hightag);
 
+// Purgable blocks thrown out to satisfy an allocation.
+extern int zonepurges;
+
 #define Z_ChangeTag(ptr, tagval) ((memblock_t *)((byte *)ptr - sizeof(memblock_t)))->tag = tagval
 
 typedef struct memblock_s